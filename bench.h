@@ -0,0 +1,69 @@
+/* what the benches share: a timer, and a replacement global allocator that counts allocations.
+ *
+ * the allocator is only there where DRIFT_COUNT_ALLOCATIONS is defined before this header is
+ * included, as it replaces operator new and delete for the whole program and so may only be in
+ * one of its translation units
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <ratio>
+
+#ifdef DRIFT_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#endif
+
+/* the best of runs calls to f, in milliseconds, or in Unit */
+template <typename Unit = std::milli, typename F>
+double best_of(int runs, F f) {
+    auto best = 1e300;
+    for (int r = 0; r != runs; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, Unit>(stop - start).count());
+    }
+    return best;
+}
+
+#ifdef DRIFT_COUNT_ALLOCATIONS
+/* the allocations that reached operator new, from any thread. every form of new and delete is
+ * replaced so that they all pair up
+ */
+inline std::atomic<std::size_t> allocations{0};
+
+namespace {
+/* out of line, so that the compiler never pairs an inlined free with the new it saw */
+__attribute__((noinline)) void release(void *p) noexcept { std::free(p); }
+} // namespace
+
+void *operator new(std::size_t size) {
+    ++allocations;
+    if (auto p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t size) { return operator new(size); }
+void *operator new(std::size_t size, std::align_val_t a) {
+    ++allocations;
+    auto align = std::size_t(a);
+    if (auto p = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t size, std::align_val_t a) { return operator new(size, a); }
+
+void operator delete(void *p) noexcept { release(p); }
+void operator delete(void *p, std::size_t) noexcept { release(p); }
+void operator delete(void *p, std::align_val_t) noexcept { release(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete[](void *p) noexcept { release(p); }
+void operator delete[](void *p, std::size_t) noexcept { release(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { release(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { release(p); }
+#endif
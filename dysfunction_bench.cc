@@ -0,0 +1,175 @@
+#include <array>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+
+#include "bench.h"
+#include "include/dysfunction.h"
+
+/* times calls and construction of drift::dysfunction against the std::function based version
+ * it replaced, which is kept below as it was, and passing callbacks as drift::dysfunction_ref
+ */
+
+namespace before {
+template <typename... Ts>
+struct overloaded : Ts... {
+    using Ts::operator()...;
+};
+
+template <typename... Ts>
+overloaded(Ts...) -> overloaded<Ts...>;
+
+template <typename R, typename... Args>
+struct dysfunction : private std::function<R(Args)>... {
+    using std::function<R(Args)>::operator()...;
+
+    template <typename... Ts>
+    dysfunction(Ts &&...ts) : dysfunction(overloaded{std::forward<Ts>(ts)...}) {}
+
+private:
+    template <typename... Ts>
+    dysfunction(overloaded<Ts...> &&ov)
+      : std::function<R(Args)>([this](Args &&args) {
+            return (*static_cast<overloaded<Ts...> *>(te_ov()))(std::forward<Args>(args));
+        })...,
+        te_ov([=]() mutable -> void * { return &ov; }) {}
+
+    std::function<void *(void)> te_ov;
+};
+} // namespace before
+
+volatile long sink;
+
+/* keeps the compiler from seeing through an object it would otherwise optimize away */
+template <typename T>
+void escape(T &t) {
+    asm volatile("" : : "g"(&t) : "memory");
+}
+
+/* the overload set both versions get: three signatures and a small capture */
+template <template <typename...> class Dysfunction>
+Dysfunction<long, int, double, const char *> make(long offset) {
+    return {[offset](int i) { return offset + i; },
+            [offset](double d) { return offset + long(d); },
+            [offset](const char *s) { return offset + long(*s); }};
+}
+
+template <template <typename...> class Dysfunction>
+void bench(const std::string &name, std::size_t n) {
+    auto f = make<Dysfunction>(1);
+    auto t_call = best_of<std::nano>(5, [&] {
+        long acc = 0;
+        for (std::size_t i = 0; i != n; ++i) {
+            acc += f(int(i));
+            acc += f(double(i));
+        }
+        sink = acc;
+    });
+
+    auto t_construct = best_of<std::nano>(5, [&] {
+        long acc = 0;
+        for (std::size_t i = 0; i != n / 16; ++i) {
+            auto g = make<Dysfunction>(long(i));
+            escape(g);
+            acc += g(1);
+        }
+        sink = acc;
+    });
+
+    std::cout << name << ":  " << t_call / double(2 * n) << " ns per call,  "
+              << t_construct / double(n / 16) << " ns per construction and destruction\n";
+}
+
+template <typename R, typename... Args>
+using inplace_dysfunction_64 = drift::inplace_dysfunction<64, R, Args...>;
+
+/* a callback-taking function that isn't inlined, called once per element */
+template <typename Callback>
+__attribute__((noinline)) long apply(Callback f, long x) {
+    return f(int(x)) + f(double(x));
+}
+
+/* with 'padding', the set is too large for dysfunction to keep in place */
+template <typename Callback, std::size_t padding>
+void bench_passing(const std::string &name, std::size_t n) {
+    long offset = 1;
+    std::array<char, padding> pad{};
+    auto set = drift::overloaded{[offset, pad](int i) { return offset + i + pad[0]; },
+                                 [offset](double d) { return offset + long(d); },
+                                 [offset](const char *s) { return offset + long(*s); }};
+    auto t = best_of<std::nano>(5, [&] {
+        long acc = 0;
+        for (std::size_t i = 0; i != n; ++i)
+            acc += apply<Callback>(set, long(i));
+        sink = acc;
+    });
+    std::cout << name << ":  " << t / double(n) << " ns per callback passed and called twice\n";
+}
+
+struct msg_a {
+    long x;
+};
+struct msg_b {
+    long x, y;
+};
+struct msg_c {
+    double d;
+};
+
+/* a random stream of three message types, one call at a time and through dispatch() */
+void bench_dispatch(std::size_t n) {
+    auto rng = std::mt19937(3);
+    auto messages = std::vector<std::variant<msg_a, msg_b, msg_c>>();
+    for (std::size_t i = 0; i != n; ++i) {
+        switch (rng() % 3) {
+        case 0: messages.emplace_back(msg_a{long(i)}); break;
+        case 1: messages.emplace_back(msg_b{long(i), 1}); break;
+        default: messages.emplace_back(msg_c{double(i)});
+        }
+    }
+
+    long acc = 0;
+    auto f = drift::dysfunction<void, const msg_a &, const msg_b &, const msg_c &>(
+        [&acc](const msg_a &m) { acc += m.x; }, [&acc](const msg_b &m) { acc += m.x * m.y; },
+        [&acc](const msg_c &m) { acc -= long(m.d); });
+
+    auto t_one = best_of<std::nano>(5, [&] {
+        for (auto &m : messages)
+            std::visit([&f](auto &alternative) { f(alternative); }, m);
+        sink = acc;
+    });
+    auto t_batch = best_of<std::nano>(5, [&] {
+        f.dispatch(messages);
+        sink = acc;
+    });
+    auto table = drift::make_dispatch_table<void, const msg_a &, const msg_b &, const msg_c &>(
+        [&acc](const msg_a &m) { acc += m.x; }, [&acc](const msg_b &m) { acc += m.x * m.y; },
+        [&acc](const msg_c &m) { acc -= long(m.d); });
+    auto t_static = best_of<std::nano>(5, [&] {
+        table.dispatch(messages);
+        sink = acc;
+    });
+
+    std::cout << "messages one at a time:  " << t_one / double(n) << " ns per message,  dispatch "
+              << t_batch / double(n) << " ns per message,  static_dysfunction "
+              << t_static / double(n) << " ns per message\n";
+}
+
+int main(int argc, char **argv) {
+    auto n = std::size_t(argc > 1 ? std::stoull(argv[1]) : 1 << 24);
+
+    bench<before::dysfunction>("std::function based", n);
+    bench<drift::dysfunction>("drift::dysfunction ", n);
+    bench<inplace_dysfunction_64>("inplace_dysfunction", n);
+    using owning = const drift::dysfunction<long, int, double, const char *> &;
+    using ref = drift::dysfunction_ref<long, int, double, const char *>;
+    bench_passing<owning, 1>("drift::dysfunction,     small set", n);
+    bench_passing<ref, 1>("drift::dysfunction_ref, small set", n);
+    bench_passing<owning, 64>("drift::dysfunction,     large set", n);
+    bench_passing<ref, 64>("drift::dysfunction_ref, large set", n);
+    bench_dispatch(n / 4);
+}
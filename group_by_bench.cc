@@ -0,0 +1,69 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+#include "bench.h"
+#include "include/drift.h"
+#include "include/relational.h"
+#include "include/tasks.h"
+
+/* times drift::group_by, serial and on pools of 1 to 64 workers, against the std::unordered_map
+ * it replaces, on a sum and a count per key
+ */
+
+volatile std::size_t sink;
+
+void bench(std::size_t n, std::uint64_t distinct) {
+    namespace agg = drift::aggregate;
+
+    /* keys are drawn from 'distinct' random ids, rather than small integers, which
+     * unordered_map's identity hash would put in buckets of their own
+     */
+    auto rng = std::mt19937_64(42);
+    auto ids = std::vector<std::uint64_t>(distinct);
+    for (auto &id : ids)
+        id = rng();
+    auto keys = std::vector<std::uint64_t>(n);
+    auto vals = std::vector<std::int64_t>(n);
+    for (std::size_t i = 0; i != n; ++i) {
+        keys[i] = ids[rng() % distinct];
+        vals[i] = std::int64_t(rng() % 1000);
+    }
+    auto table = drift::zip(keys, vals, vals);
+
+    auto t_map = best_of(3, [&] {
+        auto groups = std::unordered_map<std::uint64_t, std::pair<std::int64_t, std::size_t>>();
+        for (auto [k, v, w] : table) {
+            auto &g = groups[k];
+            g.first += v;
+            g.second += w != 0;
+        }
+        sink = groups.size();
+    });
+    auto t_serial = best_of(3, [&] {
+        sink = std::get<0>(drift::group_by(table, agg::sum, agg::count)).size();
+    });
+
+    std::cout << "n = " << n << ", " << distinct << " keys:  unordered_map " << t_map
+              << " ms,  group_by " << t_serial << " ms (" << t_map / t_serial << "x)\n";
+    for (unsigned workers = 1; workers <= 64; workers *= 2) {
+        auto pool = drift::task_stealing_queue<>(workers);
+        auto t_pool = best_of(3, [&] {
+            sink = std::get<0>(drift::group_by(pool, table, agg::sum, agg::count)).size();
+        });
+        std::cout << "  " << workers << " workers:  " << t_pool << " ms (" << t_map / t_pool
+                  << "x)\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    auto n = std::size_t(argc > 1 ? std::stoull(argv[1]) : 1 << 24);
+
+    bench(n, 1000);
+    bench(n, n / 16);
+    bench(n, n);
+}
@@ -0,0 +1,70 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+#include "bench.h"
+#include "include/drift.h"
+#include "include/relational.h"
+#include "include/tasks.h"
+
+/* times drift::hash_join, serial and on pools of 1 to 64 workers, against probing a
+ * std::unordered_multimap of the build side, on a foreign key join of a table 10 times the
+ * size of the other
+ */
+
+volatile std::size_t sink;
+
+void bench(std::size_t n_build) {
+    auto n_probe = 10 * n_build;
+    auto rng = std::mt19937_64(42);
+    /* random ids, each on a row of the build side, and a probe side referencing them */
+    auto ids = std::vector<std::uint64_t>(n_build);
+    auto amounts = std::vector<double>(n_build);
+    for (auto &id : ids)
+        id = rng();
+    auto refs = std::vector<std::uint64_t>(n_probe);
+    for (auto &ref : refs)
+        ref = ids[rng() % n_build];
+    auto build = drift::zip(ids, amounts);
+    auto probe = drift::zip(refs);
+    auto key = [](auto &&row) { return std::get<0>(row); };
+
+    auto t_map = best_of(3, [&] {
+        auto rows_of = std::unordered_multimap<std::uint64_t, std::size_t>();
+        for (std::size_t i = 0; i != n_build; ++i)
+            rows_of.emplace(ids[i], i);
+        auto build_rows = std::vector<std::size_t>();
+        auto probe_rows = std::vector<std::size_t>();
+        for (std::size_t j = 0; j != n_probe; ++j) {
+            auto range = rows_of.equal_range(refs[j]);
+            for (auto it = range.first; it != range.second; ++it) {
+                build_rows.push_back(it->second);
+                probe_rows.push_back(j);
+            }
+        }
+        sink = build_rows.size();
+    });
+    auto t_serial =
+        best_of(3, [&] { sink = std::get<0>(drift::hash_join(build, probe, key)).size(); });
+
+    std::cout << n_build << " x " << n_probe << " rows:  unordered_multimap " << t_map
+              << " ms,  hash_join " << t_serial << " ms (" << t_map / t_serial << "x)\n";
+    for (unsigned workers = 1; workers <= 64; workers *= 2) {
+        auto pool = drift::task_stealing_queue<>(workers);
+        auto t_pool = best_of(
+            3, [&] { sink = std::get<0>(drift::hash_join(pool, build, probe, key)).size(); });
+        std::cout << "  " << workers << " workers:  " << t_pool << " ms (" << t_map / t_pool
+                  << "x)\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    auto n = std::size_t(argc > 1 ? std::stoull(argv[1]) : 1 << 20);
+
+    bench(n / 64);
+    bench(n);
+}
@@ -1,9 +1,58 @@
 #pragma once
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory_resource>
 #include <numeric>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "drift.h"
+#include "simd.h"
 
 namespace drift {
 
+namespace detail {
+constexpr bool constant_evaluated() {
+#ifdef __cpp_lib_is_constant_evaluated
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+/* contiguous ranges of integers or floats, which the kernels in simd.h work on */
+template <typename Range, typename = void>
+constexpr bool is_simd_range = false;
+
+template <typename Range>
+constexpr bool is_simd_range<
+    Range, std::void_t<decltype(std::data(std::declval<Range &>())),
+                       decltype(std::size(std::declval<Range &>()))>> =
+    std::is_pointer_v<decltype(std::data(std::declval<Range &>()))> and
+    simd::is_vectorizable<
+        std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<Range &>()))>>>;
+
+template <typename Range>
+using simd_element_t =
+    std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<Range &>()))>>;
+
+/* a simd range of T, searched for or accumulated into a T */
+template <typename Range, typename T, typename = void>
+constexpr bool is_simd_range_of = false;
+
+template <typename Range, typename T>
+constexpr bool is_simd_range_of<Range, T, std::enable_if_t<is_simd_range<Range>>> =
+    std::is_same_v<simd_element_t<Range>, std::decay_t<T>>;
+} // namespace detail
+
 #define DRIFT_ONE_IN(algo)                                \
     template <typename InRange>                           \
     constexpr auto algo(InRange &&in_range) {             \
@@ -134,6 +183,77 @@ namespace drift {
                          std::forward<T1>(t1), std::forward<T2>(t2), std::forward<T3>(t3)); \
     }
 
+/* algorithms taking two full ranges */
+#define DRIFT_TWO_RANGES(algo)                                                     \
+    template <typename InRange1, typename InRange2>                                \
+    constexpr auto algo(InRange1 &&in_range1, InRange2 &&in_range2) {              \
+        using std::begin;                                                          \
+        using std::end;                                                            \
+                                                                                   \
+        return std::algo(begin(in_range1), end(in_range1), begin(in_range2),       \
+                         end(in_range2));                                          \
+    }
+
+#define DRIFT_TWO_RANGES_ONE_T(algo)                                               \
+    template <typename InRange1, typename InRange2, typename T>                    \
+    constexpr auto algo(InRange1 &&in_range1, InRange2 &&in_range2, T &&t) {       \
+        using std::begin;                                                          \
+        using std::end;                                                            \
+                                                                                   \
+        return std::algo(begin(in_range1), end(in_range1), begin(in_range2),       \
+                         end(in_range2), std::forward<T>(t));                      \
+    }
+
+#define DRIFT_TWO_RANGES_ONE_OUT(algo)                                                 \
+    template <typename InRange1, typename InRange2, typename OutRange>                 \
+    constexpr auto algo(InRange1 &&in_range1, InRange2 &&in_range2,                    \
+                        OutRange &&out_range) {                                        \
+        using std::begin;                                                              \
+        using std::end;                                                                \
+                                                                                       \
+        return std::algo(begin(in_range1), end(in_range1), begin(in_range2),           \
+                         end(in_range2), begin(out_range));                            \
+    }
+
+#define DRIFT_TWO_RANGES_ONE_OUT_ONE_T(algo)                                               \
+    template <typename InRange1, typename InRange2, typename OutRange, typename T>         \
+    constexpr auto algo(InRange1 &&in_range1, InRange2 &&in_range2, OutRange &&out_range, \
+                        T &&t) {                                                           \
+        using std::begin;                                                                  \
+        using std::end;                                                                    \
+                                                                                           \
+        return std::algo(begin(in_range1), end(in_range1), begin(in_range2),               \
+                         end(in_range2), begin(out_range), std::forward<T>(t));            \
+    }
+
+/* algorithms taking a range and an iterator into it, like std::rotate(first, middle, last) */
+#define DRIFT_ONE_IN_AT(algo)                                           \
+    template <typename InRange, typename It>                            \
+    constexpr auto algo(InRange &&in_range, It at) {                    \
+        using std::begin;                                               \
+        using std::end;                                                 \
+                                                                        \
+        return std::algo(begin(in_range), std::move(at), end(in_range)); \
+    }
+
+#define DRIFT_ONE_IN_AT_ONE_T(algo)                                                        \
+    template <typename InRange, typename It, typename T>                                   \
+    constexpr auto algo(InRange &&in_range, It at, T &&t) {                                \
+        using std::begin;                                                                  \
+        using std::end;                                                                    \
+                                                                                           \
+        return std::algo(begin(in_range), std::move(at), end(in_range), std::forward<T>(t)); \
+    }
+
+/* the _n algorithms: algo(range, n, ...) runs over the first n elements of range */
+#define DRIFT_N_ONE_T(algo)                                           \
+    template <typename InRange, typename Size, typename T>            \
+    constexpr auto algo(InRange &&in_range, Size n, T &&t) {          \
+        using std::begin;                                             \
+                                                                      \
+        return std::algo(begin(in_range), n, std::forward<T>(t));     \
+    }
+
 /* std::all_of, std::any_of, std::none_of*/
 DRIFT_ONE_IN_ONE_T(all_of)
 DRIFT_ONE_IN_ONE_T(any_of)
@@ -141,26 +261,55 @@ DRIFT_ONE_IN_ONE_T(none_of)
 
 /* std::for_each, std::for_each_n */
 DRIFT_ONE_IN_ONE_T(for_each)
-// DRIFT_ONE_IN_TWO_T(for_each_n)
+DRIFT_N_ONE_T(for_each_n)
 
 /* std::count, std::count_if */
-DRIFT_ONE_IN_ONE_T(count)
+template <typename InRange, typename T>
+constexpr auto count(InRange &&in_range, T &&t) {
+    using std::begin;
+    using std::end;
+    using difference_type = typename std::iterator_traits<decltype(begin(in_range))>::difference_type;
+
+    if constexpr (detail::is_simd_range_of<InRange, T>) {
+        if (!detail::constant_evaluated())
+            return difference_type(simd::count(std::data(in_range), std::size(in_range), t));
+    }
+    return std::count(begin(in_range), end(in_range), std::forward<T>(t));
+}
 DRIFT_ONE_IN_ONE_T(count_if)
 
 /* std::mismatch */
 DRIFT_TWO_IN(mismatch)
 
 /* std::find, std::find_if, std::find_if_not */
-DRIFT_ONE_IN_ONE_T(find)
+template <typename InRange, typename T>
+constexpr auto find(InRange &&in_range, T &&t) {
+    using std::begin;
+    using std::end;
+
+    if constexpr (detail::is_simd_range_of<InRange, T>) {
+        if (!detail::constant_evaluated())
+            return begin(in_range) + simd::find(std::data(in_range), std::size(in_range), t);
+    }
+    return std::find(begin(in_range), end(in_range), std::forward<T>(t));
+}
 DRIFT_ONE_IN_ONE_T(find_if)
 DRIFT_ONE_IN_ONE_T(find_if_not)
 
 /* find_end, find_first_of*/
+DRIFT_TWO_RANGES(find_end)
+DRIFT_TWO_RANGES_ONE_T(find_end)
+DRIFT_TWO_RANGES(find_first_of)
+DRIFT_TWO_RANGES_ONE_T(find_first_of)
+
 /* std::adjacent_find */
 DRIFT_ONE_IN(adjacent_find)
 DRIFT_ONE_IN_ONE_T(adjacent_find)
 
 /* std::search */
+DRIFT_TWO_RANGES(search)
+DRIFT_TWO_RANGES_ONE_T(search)
+
 /* std::search_n */
 DRIFT_ONE_IN_TWO_T(search_n)
 
@@ -168,6 +317,12 @@ DRIFT_ONE_IN_TWO_T(search_n)
 DRIFT_ONE_IN_ONE_OUT(copy)
 DRIFT_ONE_IN_ONE_OUT_ONE_T(copy_if)
 /* std::copy_n, std::copy_backward  */
+template <typename InRange, typename Size, typename OutRange>
+constexpr auto copy_n(InRange &&in_range, Size n, OutRange &&out_range) {
+    using std::begin;
+
+    return std::copy_n(begin(in_range), n, begin(out_range));
+}
 
 /* std::move */
 DRIFT_ONE_IN_ONE_OUT(move)
@@ -176,6 +331,7 @@ DRIFT_ONE_IN_ONE_OUT(move)
 /* std::fill */
 DRIFT_ONE_IN_ONE_T(fill)
 /* std::fill_n */
+DRIFT_N_ONE_T(fill_n)
 
 /* std::transform */
 DRIFT_ONE_IN_ONE_OUT_ONE_T(transform)
@@ -184,6 +340,7 @@ DRIFT_TWO_IN_ONE_OUT_ONE_T(transform)
 /* std::generate */
 DRIFT_ONE_IN_ONE_T(generate)
 /* std::generate_n */
+DRIFT_N_ONE_T(generate_n)
 
 /* std::remove, std::remove_if */
 DRIFT_ONE_IN_ONE_T(remove)
@@ -212,6 +369,16 @@ DRIFT_ONE_IN(reverse)
 DRIFT_ONE_IN_ONE_OUT(reverse_copy)
 
 /* std::rotate, std::rotate_copy */
+DRIFT_ONE_IN_AT(rotate)
+
+template <typename InRange, typename It, typename OutRange>
+constexpr auto rotate_copy(InRange &&in_range, It middle, OutRange &&out_range) {
+    using std::begin;
+    using std::end;
+
+    return std::rotate_copy(begin(in_range), std::move(middle), end(in_range),
+                            begin(out_range));
+}
 
 /* std::shuffle */
 DRIFT_ONE_IN_ONE_T(shuffle)
@@ -241,6 +408,12 @@ DRIFT_ONE_IN(stable_sort)
 DRIFT_ONE_IN_ONE_T(stable_sort)
 
 /* partial_sort, partial_sort_copy, nth_element */
+DRIFT_ONE_IN_AT(partial_sort)
+DRIFT_ONE_IN_AT_ONE_T(partial_sort)
+DRIFT_TWO_RANGES(partial_sort_copy)
+DRIFT_TWO_RANGES_ONE_T(partial_sort_copy)
+DRIFT_ONE_IN_AT(nth_element)
+DRIFT_ONE_IN_AT_ONE_T(nth_element)
 
 /* lower_bound, upper_bound, binary_search, equal_range */
 DRIFT_ONE_IN_ONE_T(lower_bound)
@@ -255,6 +428,158 @@ DRIFT_ONE_IN_TWO_T(equal_range)
 /* merge, inplace_merge, includes, set_difference,
    set_intersection, set_symmetric_difference, set_union */
 
+/* merge and set_intersection of two sorted contiguous ranges of the same integer type, with
+ * the default ordering, take the fast paths below: a merge without unpredictable branches,
+ * and an intersection that gallops through the longer list when the lengths are far apart.
+ */
+namespace detail {
+template <typename Range1, typename Range2>
+constexpr bool is_integer_pair =
+    is_simd_range<Range1> and is_simd_range<Range2> and
+    std::is_same_v<simd_element_t<Range1>, simd_element_t<Range2>> and
+    std::is_integral_v<simd_element_t<Range1>>;
+
+/* the first element of [first, last) that isn't less than x (or with upper, that is greater
+ * than x), probing 1, 2, 4, ... elements ahead before searching
+ */
+template <bool upper = false, typename T>
+const T *gallop(const T *first, const T *last, T x) {
+    auto before = [x](T e) { return upper ? !(x < e) : e < x; };
+    if (first == last or !before(*first))
+        return first;
+    std::ptrdiff_t step = 1;
+    while (last - first > step and before(first[step])) {
+        first += step;
+        step *= 2;
+    }
+    auto hi = last - first > step ? first + step + 1 : last;
+    return upper ? std::upper_bound(first + 1, hi, x) : std::lower_bound(first + 1, hi, x);
+}
+
+template <typename T, typename OutIt>
+OutIt merge_integers(const T *a, std::size_t n1, const T *b, std::size_t n2, OutIt out) {
+    /* far apart lengths: copy the runs of the long input between the short one's elements */
+    if (n1 / 16 > n2) {
+        auto p = a;
+        for (std::size_t j = 0; j != n2; ++j) {
+            auto q = gallop<true>(p, a + n1, b[j]);
+            out = std::copy(p, q, out);
+            *out = b[j];
+            ++out;
+            p = q;
+        }
+        return std::copy(p, a + n1, out);
+    }
+    if (n2 / 16 > n1) {
+        auto p = b;
+        for (std::size_t i = 0; i != n1; ++i) {
+            auto q = gallop(p, b + n2, a[i]);
+            out = std::copy(p, q, out);
+            *out = a[i];
+            ++out;
+            p = q;
+        }
+        return std::copy(p, b + n2, out);
+    }
+
+    std::size_t i = 0, j = 0;
+    while (i != n1 and j != n2) {
+        /* on ties a goes first, as in std::merge */
+        bool from_b = b[j] < a[i];
+        *out = from_b ? b[j] : a[i];
+        ++out;
+        j += from_b;
+        i += !from_b;
+    }
+    out = std::copy(a + i, a + n1, out);
+    return std::copy(b + j, b + n2, out);
+}
+
+template <typename T, typename OutIt>
+OutIt intersect_integers(const T *a, std::size_t n1, const T *b, std::size_t n2, OutIt out) {
+    if (n1 > n2) {
+        std::swap(a, b);
+        std::swap(n1, n2);
+    }
+
+    if (n2 / 16 > n1) {
+        auto p = b, end = b + n2;
+        for (std::size_t i = 0; i != n1 and p != end; ++i) {
+            p = gallop(p, end, a[i]);
+            if (p != end and *p == a[i]) {
+                *out = a[i];
+                ++out;
+                ++p;
+            }
+        }
+        return out;
+    }
+
+    std::size_t i = 0, j = 0;
+    while (i != n1 and j != n2) {
+        auto x = a[i], y = b[j];
+        if (x == y) {
+            *out = x;
+            ++out;
+            ++i;
+            ++j;
+        } else {
+            i += x < y;
+            j += y < x;
+        }
+    }
+    return out;
+}
+} // namespace detail
+
+template <typename InRange1, typename InRange2, typename OutRange>
+constexpr auto merge(InRange1 &&in_range1, InRange2 &&in_range2, OutRange &&out_range) {
+    using std::begin;
+    using std::end;
+
+    if constexpr (detail::is_integer_pair<InRange1, InRange2>) {
+        if (!detail::constant_evaluated())
+            return detail::merge_integers(std::data(in_range1), std::size(in_range1),
+                                          std::data(in_range2), std::size(in_range2),
+                                          begin(out_range));
+    }
+    return std::merge(begin(in_range1), end(in_range1), begin(in_range2), end(in_range2),
+                      begin(out_range));
+}
+DRIFT_TWO_RANGES_ONE_OUT_ONE_T(merge)
+
+DRIFT_ONE_IN_AT(inplace_merge)
+DRIFT_ONE_IN_AT_ONE_T(inplace_merge)
+
+DRIFT_TWO_RANGES(includes)
+DRIFT_TWO_RANGES_ONE_T(includes)
+
+DRIFT_TWO_RANGES_ONE_OUT(set_difference)
+DRIFT_TWO_RANGES_ONE_OUT_ONE_T(set_difference)
+
+template <typename InRange1, typename InRange2, typename OutRange>
+constexpr auto set_intersection(InRange1 &&in_range1, InRange2 &&in_range2,
+                                OutRange &&out_range) {
+    using std::begin;
+    using std::end;
+
+    if constexpr (detail::is_integer_pair<InRange1, InRange2>) {
+        if (!detail::constant_evaluated())
+            return detail::intersect_integers(std::data(in_range1), std::size(in_range1),
+                                              std::data(in_range2), std::size(in_range2),
+                                              begin(out_range));
+    }
+    return std::set_intersection(begin(in_range1), end(in_range1), begin(in_range2),
+                                 end(in_range2), begin(out_range));
+}
+DRIFT_TWO_RANGES_ONE_OUT_ONE_T(set_intersection)
+
+DRIFT_TWO_RANGES_ONE_OUT(set_symmetric_difference)
+DRIFT_TWO_RANGES_ONE_OUT_ONE_T(set_symmetric_difference)
+
+DRIFT_TWO_RANGES_ONE_OUT(set_union)
+DRIFT_TWO_RANGES_ONE_OUT_ONE_T(set_union)
+
 /* is_heap */
 
 DRIFT_ONE_IN(is_heap)
@@ -275,11 +600,60 @@ DRIFT_ONE_IN_ONE_T(sort_heap)
 /* max, min, minmax */
 /* max_element, min_element, minmax_element */
 
-DRIFT_ONE_IN(max_element)
+/* the simd versions find the extremes, and then their first (or for minmax_element's max,
+ * last) position; ranges with nans take the std:: path, whose results depend on where the
+ * nans are.
+ */
+template <typename InRange>
+constexpr auto max_element(InRange &&in_range) {
+    using std::begin;
+    using std::end;
+
+    if constexpr (detail::is_simd_range<InRange>) {
+        auto p = std::data(in_range);
+        auto n = std::size(in_range);
+        if (!detail::constant_evaluated() and n != 0) {
+            if (auto e = simd::minmax(p, n); !e.unordered)
+                return begin(in_range) + simd::find(p, n, e.max);
+        }
+    }
+    return std::max_element(begin(in_range), end(in_range));
+}
 DRIFT_ONE_IN_ONE_T(max_element)
-DRIFT_ONE_IN(min_element)
+
+template <typename InRange>
+constexpr auto min_element(InRange &&in_range) {
+    using std::begin;
+    using std::end;
+
+    if constexpr (detail::is_simd_range<InRange>) {
+        auto p = std::data(in_range);
+        auto n = std::size(in_range);
+        if (!detail::constant_evaluated() and n != 0) {
+            if (auto e = simd::minmax(p, n); !e.unordered)
+                return begin(in_range) + simd::find(p, n, e.min);
+        }
+    }
+    return std::min_element(begin(in_range), end(in_range));
+}
 DRIFT_ONE_IN_ONE_T(min_element)
-DRIFT_ONE_IN(minmax_element)
+
+template <typename InRange>
+constexpr auto minmax_element(InRange &&in_range) {
+    using std::begin;
+    using std::end;
+
+    if constexpr (detail::is_simd_range<InRange>) {
+        auto p = std::data(in_range);
+        auto n = std::size(in_range);
+        if (!detail::constant_evaluated() and n != 0) {
+            if (auto e = simd::minmax(p, n); !e.unordered)
+                return std::make_pair(begin(in_range) + simd::find(p, n, e.min),
+                                      begin(in_range) + simd::find_last(p, n, e.max));
+        }
+    }
+    return std::minmax_element(begin(in_range), end(in_range));
+}
 DRIFT_ONE_IN_ONE_T(minmax_element)
 
 /* clamp */
@@ -305,45 +679,380 @@ DRIFT_TWO_IN_ONE_T(prev_permutation)
 DRIFT_ONE_IN_ONE_T(iota)
 
 /* accumulate */
-DRIFT_ONE_IN_ONE_T(accumulate)
+/* integer sums go through simd.h; floating point ones keep their left to right order */
+template <typename InRange, typename T>
+constexpr auto accumulate(InRange &&in_range, T &&t) {
+    using std::begin;
+    using std::end;
+
+    if constexpr (detail::is_simd_range_of<InRange, T> and std::is_integral_v<std::decay_t<T>>) {
+        if (!detail::constant_evaluated())
+            return simd::sum(std::data(in_range), std::size(in_range), t);
+    }
+    return std::accumulate(begin(in_range), end(in_range), std::forward<T>(t));
+}
 DRIFT_ONE_IN_TWO_T(accumulate)
 
 /* inner_product */
-DRIFT_TWO_IN_ONE_T(inner_product)
+template <typename InRange1, typename InRange2, typename T>
+constexpr auto inner_product(InRange1 &&in_range1, InRange2 &&in_range2, T &&t) {
+    using std::begin;
+    using std::end;
+
+    if constexpr (detail::is_simd_range_of<InRange1, T> and detail::is_simd_range_of<InRange2, T> and
+                  std::is_integral_v<std::decay_t<T>>) {
+        if (!detail::constant_evaluated())
+            return simd::dot(std::data(in_range1), std::data(in_range2), std::size(in_range1), t);
+    }
+    return std::inner_product(begin(in_range1), end(in_range1), begin(in_range2),
+                              std::forward<T>(t));
+}
 DRIFT_TWO_IN_THREE_T(inner_product)
 
 /* adjacent_difference */
 DRIFT_ONE_IN_ONE_OUT(adjacent_difference)
 DRIFT_ONE_IN_ONE_OUT_ONE_T(adjacent_difference)
 
-#ifndef __GLIBCXX__
 /* partial_sum */
+
+/* reduce, exclusive_scan, inclusive_scan, transform_reduce, transform_exclusive_scan,
+ * transform_inclusive_scan
+ *
+ * drift's own versions, so they exist on every standard library. they go left to right like
+ * accumulate and partial_sum do; reduce and transform_reduce also take drift::unseq as their
+ * first argument, which lets them reassociate: they then fold random access ranges into
+ * eight independent accumulators, which the compiler can pipeline and vectorize even for
+ * floating point. the operation must be associative and commutative for that, and floating
+ * point results change with the order.
+ */
+struct unseq_t {};
+inline constexpr unseq_t unseq{};
+
+/* elementwise(op) applies op to two tuples one element at a time, returning a tuple of the
+ * results; elementwise(op1, op2, ...) applies op1 to the first elements, op2 to the second
+ * ones, and so on. it lets the reductions and scans here work on zips of several columns.
+ */
+template <typename... Ops>
+class elementwise_op {
+    std::tuple<Ops...> ops;
+
+    template <std::size_t I>
+    constexpr const auto &op() const {
+        if constexpr (sizeof...(Ops) == 1)
+            return std::get<0>(ops);
+        else
+            return std::get<I>(ops);
+    }
+
+    template <typename A, typename B, std::size_t... I>
+    constexpr auto apply(A &&a, B &&b, std::index_sequence<I...>) const {
+        return std::make_tuple(op<I>()(std::get<I>(std::forward<A>(a)),
+                                       std::get<I>(std::forward<B>(b)))...);
+    }
+
+public:
+    constexpr explicit elementwise_op(Ops... ops) : ops(std::move(ops)...) {}
+
+    template <typename A, typename B>
+    constexpr auto operator()(A &&a, B &&b) const {
+        constexpr auto size = std::tuple_size_v<std::decay_t<A>>;
+        static_assert(sizeof...(Ops) == 1 or sizeof...(Ops) == size,
+                      "elementwise needs one operation, or one per element");
+        return apply(std::forward<A>(a), std::forward<B>(b), std::make_index_sequence<size>());
+    }
+};
+
+template <typename... Ops>
+constexpr auto elementwise(Ops... ops) {
+    return elementwise_op<Ops...>(std::move(ops)...);
+}
+
+namespace detail {
+struct identity {
+    template <typename T>
+    constexpr T &&operator()(T &&t) const noexcept {
+        return std::forward<T>(t);
+    }
+};
+
+template <typename It, typename T, typename BinaryOp, typename UnaryOp>
+constexpr T transform_fold(It first, It last, T init, BinaryOp &op, UnaryOp &f) {
+    for (; first != last; ++first)
+        init = op(std::move(init), f(*first));
+    return init;
+}
+
+template <typename It1, typename It2, typename T, typename BinaryOp, typename BinaryOp2>
+constexpr T transform_fold(It1 first1, It1 last1, It2 first2, T init, BinaryOp &op,
+                           BinaryOp2 &f) {
+    for (; first1 != last1; ++first1, ++first2)
+        init = op(std::move(init), f(*first1, *first2));
+    return init;
+}
+
+constexpr std::size_t unseq_lanes = 8;
+
+template <typename T, typename F, std::size_t... Lanes>
+constexpr std::array<T, sizeof...(Lanes)> make_lanes(F &f, std::index_sequence<Lanes...>) {
+    return {{T(f(std::ptrdiff_t(Lanes)))...}};
+}
+
+/* folds at(0), ..., at(n - 1) into init, in lanes that are combined pairwise at the end */
+template <typename T, typename BinaryOp, typename At>
+constexpr T unseq_fold(std::ptrdiff_t n, T init, BinaryOp &op, At at) {
+    constexpr auto lanes = std::ptrdiff_t(unseq_lanes);
+    std::ptrdiff_t i = 0;
+    if (n >= 2 * lanes) {
+        auto acc = make_lanes<T>(at, std::make_index_sequence<unseq_lanes>());
+        for (i = lanes; n - i >= lanes; i += lanes)
+            for (std::ptrdiff_t l = 0; l != lanes; ++l)
+                acc[l] = op(std::move(acc[l]), at(i + l));
+        for (auto width = lanes / 2; width != 0; width /= 2)
+            for (std::ptrdiff_t l = 0; l != width; ++l)
+                acc[l] = op(std::move(acc[l]), std::move(acc[l + width]));
+        init = op(std::move(init), std::move(acc[0]));
+    }
+    for (; i != n; ++i)
+        init = op(std::move(init), at(i));
+    return init;
+}
+
+template <typename It, typename OutIt, typename T, typename BinaryOp, typename UnaryOp>
+constexpr OutIt transform_exclusive_scan(It first, It last, OutIt out, T init, BinaryOp &op,
+                                         UnaryOp &f) {
+    for (; first != last; ++first, ++out) {
+        /* read before writing, so that out may be first */
+        auto next = op(init, f(*first));
+        *out = std::move(init);
+        init = std::move(next);
+    }
+    return out;
+}
+
+template <typename It, typename OutIt, typename T, typename BinaryOp, typename UnaryOp>
+constexpr OutIt transform_inclusive_scan(It first, It last, OutIt out, T init, BinaryOp &op,
+                                         UnaryOp &f) {
+    for (; first != last; ++first, ++out) {
+        init = op(std::move(init), f(*first));
+        *out = init;
+    }
+    return out;
+}
+
+/* inclusive scans without an init start from their first element, transformed. like the
+ * standard's, the sum has the transform's result type, or the input's value type for plain
+ * scans, whose identity would otherwise keep proxy references
+ */
+template <typename It, typename OutIt, typename BinaryOp, typename UnaryOp>
+constexpr OutIt transform_inclusive_scan(It first, It last, OutIt out, BinaryOp &op,
+                                         UnaryOp &f) {
+    using result = std::decay_t<std::invoke_result_t<UnaryOp &, iter_reference_t<It>>>;
+    using T = std::conditional_t<std::is_same_v<UnaryOp, identity>, iter_value_t<It>, result>;
+    if (first == last)
+        return out;
+    auto init = T(f(*first));
+    *out = init;
+    return detail::transform_inclusive_scan(++first, last, ++out, std::move(init), op, f);
+}
+} // namespace detail
+
 /* reduce */
-DRIFT_ONE_IN_ONE_T(reduce)
-DRIFT_ONE_IN_TWO_T(reduce)
+template <typename InRange, typename T, typename BinaryOp>
+constexpr T reduce(InRange &&in_range, T init, BinaryOp op) {
+    using std::begin;
+    using std::end;
+
+    auto f = detail::identity();
+    return detail::transform_fold(begin(in_range), end(in_range), std::move(init), op, f);
+}
+
+template <typename InRange, typename T>
+constexpr T reduce(InRange &&in_range, T init) {
+    return drift::reduce(std::forward<InRange>(in_range), std::move(init), std::plus<>());
+}
+
+template <typename InRange>
+constexpr auto reduce(InRange &&in_range) {
+    using std::begin;
+    using T = iter_value_t<decltype(begin(in_range))>;
+
+    return drift::reduce(std::forward<InRange>(in_range), T(), std::plus<>());
+}
+
+template <typename InRange, typename T, typename BinaryOp, typename UnaryOp>
+constexpr T transform_reduce(unseq_t, InRange &&in_range, T init, BinaryOp reduce_op,
+                             UnaryOp transform_op);
+
+template <typename InRange, typename T, typename BinaryOp>
+constexpr T reduce(unseq_t, InRange &&in_range, T init, BinaryOp op) {
+    return drift::transform_reduce(unseq, std::forward<InRange>(in_range), std::move(init), op,
+                                   detail::identity());
+}
+
+template <typename InRange, typename T>
+constexpr T reduce(unseq_t, InRange &&in_range, T init) {
+    return drift::reduce(unseq, std::forward<InRange>(in_range), std::move(init),
+                         std::plus<>());
+}
+
+template <typename InRange>
+constexpr auto reduce(unseq_t, InRange &&in_range) {
+    using std::begin;
+    using T = iter_value_t<decltype(begin(in_range))>;
+
+    return drift::reduce(unseq, std::forward<InRange>(in_range), T(), std::plus<>());
+}
 
 /* exclusive_scan */
-DRIFT_ONE_IN_ONE_OUT_ONE_T(exclusive_scan)
-DRIFT_ONE_IN_ONE_OUT_TWO_T(exclusive_scan)
+template <typename InRange, typename OutRange, typename T, typename BinaryOp>
+constexpr auto exclusive_scan(InRange &&in_range, OutRange &&out_range, T init, BinaryOp op) {
+    using std::begin;
+    using std::end;
+
+    auto f = detail::identity();
+    return detail::transform_exclusive_scan(begin(in_range), end(in_range), begin(out_range),
+                                            std::move(init), op, f);
+}
+
+template <typename InRange, typename OutRange, typename T>
+constexpr auto exclusive_scan(InRange &&in_range, OutRange &&out_range, T init) {
+    return drift::exclusive_scan(std::forward<InRange>(in_range),
+                                 std::forward<OutRange>(out_range), std::move(init),
+                                 std::plus<>());
+}
 
 /* inclusive_scan */
-DRIFT_ONE_IN_ONE_OUT(inclusive_scan)
-DRIFT_ONE_IN_ONE_OUT_ONE_T(inclusive_scan)
-DRIFT_ONE_IN_ONE_OUT_TWO_T(inclusive_scan)
+template <typename InRange, typename OutRange, typename BinaryOp, typename T>
+constexpr auto inclusive_scan(InRange &&in_range, OutRange &&out_range, BinaryOp op, T init) {
+    using std::begin;
+    using std::end;
+
+    auto f = detail::identity();
+    return detail::transform_inclusive_scan(begin(in_range), end(in_range), begin(out_range),
+                                            std::move(init), op, f);
+}
+
+template <typename InRange, typename OutRange, typename BinaryOp>
+constexpr auto inclusive_scan(InRange &&in_range, OutRange &&out_range, BinaryOp op) {
+    using std::begin;
+    using std::end;
+
+    auto f = detail::identity();
+    return detail::transform_inclusive_scan(begin(in_range), end(in_range), begin(out_range),
+                                            op, f);
+}
+
+template <typename InRange, typename OutRange>
+constexpr auto inclusive_scan(InRange &&in_range, OutRange &&out_range) {
+    return drift::inclusive_scan(std::forward<InRange>(in_range),
+                                 std::forward<OutRange>(out_range), std::plus<>());
+}
 
 /* transform_reduce */
-DRIFT_TWO_IN_ONE_T(transform_reduce)
-DRIFT_TWO_IN_THREE_T(transform_reduce)
-DRIFT_ONE_IN_THREE_T(transform_reduce)
+template <typename InRange1, typename InRange2, typename T, typename BinaryOp1,
+          typename BinaryOp2>
+constexpr T transform_reduce(InRange1 &&in_range1, InRange2 &&in_range2, T init,
+                             BinaryOp1 reduce_op, BinaryOp2 transform_op) {
+    using std::begin;
+    using std::end;
+
+    return detail::transform_fold(begin(in_range1), end(in_range1), begin(in_range2),
+                                  std::move(init), reduce_op, transform_op);
+}
+
+template <typename InRange1, typename InRange2, typename T>
+constexpr T transform_reduce(InRange1 &&in_range1, InRange2 &&in_range2, T init) {
+    return drift::transform_reduce(std::forward<InRange1>(in_range1),
+                                   std::forward<InRange2>(in_range2), std::move(init),
+                                   std::plus<>(), std::multiplies<>());
+}
+
+template <typename InRange, typename T, typename BinaryOp, typename UnaryOp>
+constexpr T transform_reduce(InRange &&in_range, T init, BinaryOp reduce_op,
+                             UnaryOp transform_op) {
+    using std::begin;
+    using std::end;
+
+    return detail::transform_fold(begin(in_range), end(in_range), std::move(init), reduce_op,
+                                  transform_op);
+}
+
+template <typename InRange, typename T, typename BinaryOp, typename UnaryOp>
+constexpr T transform_reduce(unseq_t, InRange &&in_range, T init, BinaryOp reduce_op,
+                             UnaryOp transform_op) {
+    using std::begin;
+    using std::end;
+
+    auto first = begin(in_range);
+    if constexpr (detail::is_random_access<iterator_category_t<decltype(first)>>) {
+        auto n = std::ptrdiff_t(end(in_range) - first);
+        return detail::unseq_fold(n, std::move(init), reduce_op,
+                                  [&](std::ptrdiff_t i) { return transform_op(first[i]); });
+    } else {
+        return detail::transform_fold(first, end(in_range), std::move(init), reduce_op,
+                                      transform_op);
+    }
+}
+
+template <typename InRange1, typename InRange2, typename T, typename BinaryOp1,
+          typename BinaryOp2>
+constexpr T transform_reduce(unseq_t, InRange1 &&in_range1, InRange2 &&in_range2, T init,
+                             BinaryOp1 reduce_op, BinaryOp2 transform_op) {
+    using std::begin;
+    using std::end;
+
+    auto first1 = begin(in_range1);
+    auto first2 = begin(in_range2);
+    if constexpr (detail::is_random_access<iterator_category_t<decltype(first1)>> and
+                  detail::is_random_access<iterator_category_t<decltype(first2)>>) {
+        auto n = std::ptrdiff_t(end(in_range1) - first1);
+        return detail::unseq_fold(n, std::move(init), reduce_op, [&](std::ptrdiff_t i) {
+            return transform_op(first1[i], first2[i]);
+        });
+    } else {
+        return detail::transform_fold(first1, end(in_range1), first2, std::move(init),
+                                      reduce_op, transform_op);
+    }
+}
+
+template <typename InRange1, typename InRange2, typename T>
+constexpr T transform_reduce(unseq_t, InRange1 &&in_range1, InRange2 &&in_range2, T init) {
+    return drift::transform_reduce(unseq, std::forward<InRange1>(in_range1),
+                                   std::forward<InRange2>(in_range2), std::move(init),
+                                   std::plus<>(), std::multiplies<>());
+}
 
 /* transform_exclusive_scan */
-DRIFT_ONE_IN_ONE_OUT_THREE_T(transform_exclusive_scan)
+template <typename InRange, typename OutRange, typename T, typename BinaryOp, typename UnaryOp>
+constexpr auto transform_exclusive_scan(InRange &&in_range, OutRange &&out_range, T init,
+                                        BinaryOp reduce_op, UnaryOp transform_op) {
+    using std::begin;
+    using std::end;
 
-/* transform_inclusive_scan */
-DRIFT_ONE_IN_ONE_OUT_TWO_T(transform_inclusive_scan)
-DRIFT_ONE_IN_ONE_OUT_THREE_T(transform_inclusive_scan)
+    return detail::transform_exclusive_scan(begin(in_range), end(in_range), begin(out_range),
+                                            std::move(init), reduce_op, transform_op);
+}
 
-#endif
+/* transform_inclusive_scan */
+template <typename InRange, typename OutRange, typename BinaryOp, typename UnaryOp, typename T>
+constexpr auto transform_inclusive_scan(InRange &&in_range, OutRange &&out_range,
+                                        BinaryOp reduce_op, UnaryOp transform_op, T init) {
+    using std::begin;
+    using std::end;
+
+    return detail::transform_inclusive_scan(begin(in_range), end(in_range), begin(out_range),
+                                            std::move(init), reduce_op, transform_op);
+}
+
+template <typename InRange, typename OutRange, typename BinaryOp, typename UnaryOp>
+constexpr auto transform_inclusive_scan(InRange &&in_range, OutRange &&out_range,
+                                        BinaryOp reduce_op, UnaryOp transform_op) {
+    using std::begin;
+    using std::end;
+
+    return detail::transform_inclusive_scan(begin(in_range), end(in_range), begin(out_range),
+                                            reduce_op, transform_op);
+}
 
 /* Operations on uninitialized memory */
 /* uninitialized_copy */
@@ -394,4 +1103,1127 @@ DRIFT_ONE_IN(destroy)
 #undef DRIFT_TWO_IN_THREE_T
 #undef DRIFT_TWO_IN_ONE_OUT_ONE_T
 
-} // namespace drift
\ No newline at end of file
+#undef DRIFT_TWO_RANGES
+#undef DRIFT_TWO_RANGES_ONE_T
+#undef DRIFT_TWO_RANGES_ONE_OUT
+#undef DRIFT_TWO_RANGES_ONE_OUT_ONE_T
+
+#undef DRIFT_ONE_IN_AT
+#undef DRIFT_ONE_IN_AT_ONE_T
+#undef DRIFT_N_ONE_T
+
+/* parallel algorithms
+ *
+ * these take a task pool from tasks.h (or anything with an async(f) member returning a
+ * std::future<void>) as their first argument. the calling thread does the splitting and
+ * then blocks until every task has finished, so it shouldn't be one of the pool's workers.
+ */
+namespace detail {
+template <typename Futures>
+void wait_all(Futures &futures) {
+    for (auto &f : futures)
+        f.wait();
+    for (auto &f : futures)
+        f.get();
+}
+
+template <typename Pool, typename = void>
+constexpr bool has_n_workers = false;
+
+template <typename Pool>
+constexpr bool has_n_workers<Pool, std::void_t<decltype(std::declval<Pool &>().n_workers())>> =
+    true;
+
+/* how many tasks the pool runs at once */
+template <typename Pool>
+unsigned concurrency(Pool &pool) {
+    if constexpr (has_n_workers<Pool>)
+        return std::max(1u, unsigned(pool.n_workers()));
+    else
+        return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/* splits n elements into at most 'max_chunks' chunks of at least 'min_chunk' elements;
+ * chunk c is [bound(c), bound(c + 1)).
+ */
+struct chunking {
+    std::size_t n, chunks;
+
+    chunking(std::size_t n, std::size_t max_chunks, std::size_t min_chunk)
+      : n(n), chunks(std::max<std::size_t>(
+                  1, std::min(max_chunks, n / std::max<std::size_t>(1, min_chunk)))) {}
+
+    std::size_t bound(std::size_t c) const { return n / chunks * c + std::min(c, n % chunks); }
+};
+
+/* runs f(0), ..., f(chunks - 1), as pool tasks when there is more than one */
+template <typename Pool, typename F>
+void run_chunks(Pool &pool, std::size_t chunks, F &&f) {
+    if (chunks == 1)
+        return f(std::size_t(0));
+    std::vector<std::future<void>> futures;
+    futures.reserve(chunks);
+    for (std::size_t c = 0; c != chunks; ++c)
+        futures.push_back(pool.async([&f, c] { f(c); }));
+    wait_all(futures);
+}
+
+/* stands in for a pool where an algorithm can run serially or in parallel */
+struct no_pool {
+    unsigned n_workers() const { return 1; }
+
+    template <typename F>
+    std::future<void> async(F &&f) {
+        auto done = std::promise<void>();
+        f();
+        done.set_value();
+        return done.get_future();
+    }
+};
+
+template <typename Pool, typename = void>
+constexpr bool has_resource = false;
+
+template <typename Pool>
+constexpr bool has_resource<Pool, std::void_t<decltype(std::declval<Pool &>().resource())>> =
+    true;
+
+/* where an algorithm running on the pool takes its scratch space from */
+template <typename Pool>
+std::pmr::memory_resource *scratch_resource(Pool &pool) {
+    if constexpr (has_resource<Pool>)
+        return pool.resource();
+    else
+        return std::pmr::get_default_resource();
+}
+
+template <typename T>
+using scratch_vector = std::pmr::vector<T>;
+
+inline std::ptrdiff_t default_grain(std::ptrdiff_t n) {
+    auto tasks = 8 * std::ptrdiff_t(std::max(1u, std::thread::hardware_concurrency()));
+    return std::max(std::ptrdiff_t(1), n / tasks);
+}
+
+template <typename Pool, typename Range, typename F, typename Futures>
+void parallel_for_each_impl(Pool &pool, const Range &range, F &f, std::ptrdiff_t grain,
+                            Futures &futures) {
+    if (range.size() <= grain) {
+        futures.push_back(pool.async([&f, range] {
+            for (auto &&x : range)
+                f(std::forward<decltype(x)>(x));
+        }));
+        return;
+    }
+    auto [lo, hi] = range.split();
+    parallel_for_each_impl(pool, lo, f, grain, futures);
+    parallel_for_each_impl(pool, hi, f, grain, futures);
+}
+} // namespace detail
+
+/* a pool that runs its tasks on another, and whose algorithms take their scratch space, such as
+ * sort and partition buffers, from resource. the tasks of an algorithm allocate at once, so
+ * the resource has to be thread safe; a per-request std::pmr::monotonic_buffer_resource
+ * wrapped in a synchronized_resource frees all of it at once when the request ends.
+ */
+template <typename Pool>
+class resource_pool {
+public:
+    resource_pool(Pool &pool, std::pmr::memory_resource *resource)
+      : pool_(pool), resource_(resource) {}
+
+    unsigned n_workers() const { return detail::concurrency(pool_); }
+    std::pmr::memory_resource *resource() const { return resource_; }
+
+    template <typename F>
+    auto async(F &&f) {
+        return pool_.async(std::forward<F>(f));
+    }
+
+private:
+    Pool &pool_;
+    std::pmr::memory_resource *resource_;
+};
+
+template <typename Pool>
+resource_pool<Pool> with_resource(Pool &pool, std::pmr::memory_resource *resource) {
+    return {pool, resource};
+}
+
+/* recursively halves a random access range down to 'grain' elements and runs f over every
+ * element, one task per piece. pieces of indexed() ranges keep their global indices.
+ */
+template <typename Pool, typename Range, typename F>
+void parallel_for_each(Pool &pool, Range &&range, F f, std::ptrdiff_t grain = 0) {
+    using std::begin;
+    using std::end;
+
+    auto n = std::ptrdiff_t(std::distance(begin(range), end(range)));
+    if (n == 0)
+        return;
+    if (grain <= 0)
+        grain = detail::default_grain(n);
+
+    std::vector<std::future<void>> futures;
+    if constexpr (is_splittable_v<Range>)
+        detail::parallel_for_each_impl(pool, range, f, grain, futures);
+    else
+        detail::parallel_for_each_impl(pool, slice(begin(range), end(range)), f, grain, futures);
+    detail::wait_all(futures);
+}
+
+/* parallel scans, by reduce-then-scan: every chunk of the input is reduced, the chunk sums
+ * are scanned serially, and then every chunk is scanned starting from its own offset. that
+ * reads the input twice and writes the output once, and works for any associative op.
+ * in and out may be the same range.
+ */
+namespace detail {
+template <typename T, typename Pool, typename It, typename OutIt, typename BinaryOp>
+OutIt parallel_scan(Pool &pool, It first, It last, OutIt out, std::optional<T> init,
+                    BinaryOp &op, bool inclusive) {
+    static_assert(is_random_access<iterator_category_t<It>> and
+                      is_random_access<iterator_category_t<OutIt>>,
+                  "parallel scans need random access ranges");
+
+    auto n = std::size_t(last - first);
+    auto chunks = chunking(n, concurrency(pool), std::size_t(1) << 14);
+    auto f = identity();
+
+    /* the last chunk's sum is never needed */
+    auto sums = std::vector<std::optional<T>>(chunks.chunks);
+    run_chunks(pool, chunks.chunks - 1, [&](std::size_t c) {
+        auto lo = first + chunks.bound(c), hi = first + chunks.bound(c + 1);
+        sums[c].emplace(*lo);
+        sums[c] = transform_fold(lo + 1, hi, std::move(*sums[c]), op, f);
+    });
+
+    auto offsets = std::vector<std::optional<T>>(chunks.chunks);
+    offsets[0] = std::move(init);
+    for (std::size_t c = 1; c < chunks.chunks; ++c)
+        offsets[c] = offsets[c - 1] ? op(*offsets[c - 1], std::move(*sums[c - 1]))
+                                    : std::move(*sums[c - 1]);
+
+    run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        auto lo = first + chunks.bound(c), hi = first + chunks.bound(c + 1);
+        auto to = out + chunks.bound(c);
+        if (!inclusive)
+            detail::transform_exclusive_scan(lo, hi, to, std::move(*offsets[c]), op, f);
+        else if (offsets[c])
+            detail::transform_inclusive_scan(lo, hi, to, std::move(*offsets[c]), op, f);
+        else
+            detail::transform_inclusive_scan(lo, hi, to, op, f);
+    });
+    return out + n;
+}
+} // namespace detail
+
+template <typename Pool, typename InRange, typename OutRange, typename BinaryOp, typename T>
+auto parallel_inclusive_scan(Pool &pool, InRange &&in_range, OutRange &&out_range,
+                             BinaryOp op, T init) {
+    using std::begin;
+    using std::end;
+
+    return detail::parallel_scan<T>(pool, begin(in_range), end(in_range), begin(out_range),
+                                    std::optional<T>(std::move(init)), op, true);
+}
+
+template <typename Pool, typename InRange, typename OutRange, typename BinaryOp>
+auto parallel_inclusive_scan(Pool &pool, InRange &&in_range, OutRange &&out_range,
+                             BinaryOp op) {
+    using std::begin;
+    using std::end;
+    using T = iter_value_t<decltype(begin(in_range))>;
+
+    return detail::parallel_scan<T>(pool, begin(in_range), end(in_range), begin(out_range),
+                                    std::optional<T>(), op, true);
+}
+
+template <typename Pool, typename InRange, typename OutRange>
+auto parallel_inclusive_scan(Pool &pool, InRange &&in_range, OutRange &&out_range) {
+    return drift::parallel_inclusive_scan(pool, std::forward<InRange>(in_range),
+                                          std::forward<OutRange>(out_range), std::plus<>());
+}
+
+template <typename Pool, typename InRange, typename OutRange, typename T, typename BinaryOp>
+auto parallel_exclusive_scan(Pool &pool, InRange &&in_range, OutRange &&out_range, T init,
+                             BinaryOp op) {
+    using std::begin;
+    using std::end;
+
+    return detail::parallel_scan<T>(pool, begin(in_range), end(in_range), begin(out_range),
+                                    std::optional<T>(std::move(init)), op, false);
+}
+
+template <typename Pool, typename InRange, typename OutRange, typename T>
+auto parallel_exclusive_scan(Pool &pool, InRange &&in_range, OutRange &&out_range, T init) {
+    return drift::parallel_exclusive_scan(pool, std::forward<InRange>(in_range),
+                                          std::forward<OutRange>(out_range), std::move(init),
+                                          std::plus<>());
+}
+
+/* parallel stream compaction and partitioning
+ *
+ * every chunk of the input counts the elements it keeps, the counts are prefix summed into
+ * each chunk's place in the output, and then every chunk copies or moves its elements there.
+ * pred is called twice on every element, so it should be cheap and give the same answer both
+ * times. all of these keep the relative order of the elements; the in-place ones go through
+ * a scratch copy of what they keep. zips of several columns are compacted together.
+ */
+namespace detail {
+/* offsets[c] is the number of elements satisfying pred before chunk c; offsets.back() is
+ * their total
+ */
+template <typename Pool, typename It, typename Pred>
+std::vector<std::size_t> count_by_chunk(Pool &pool, It first, const chunking &chunks,
+                                        Pred &pred) {
+    static_assert(is_random_access<iterator_category_t<It>>,
+                  "parallel compaction needs random access ranges");
+
+    auto offsets = std::vector<std::size_t>(chunks.chunks + 1);
+    run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        std::size_t count = 0;
+        for (auto i = chunks.bound(c); i != chunks.bound(c + 1); ++i)
+            count += bool(pred(first[i]));
+        offsets[c + 1] = count;
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    return offsets;
+}
+
+inline chunking compaction_chunks(std::size_t n, unsigned workers) {
+    return chunking(n, workers, std::size_t(1) << 14);
+}
+
+/* moves the elements of first for which pred holds to the front, in order, and returns how
+ * many there are
+ */
+template <typename Pool, typename It, typename Pred>
+std::size_t parallel_stable_partition(Pool &pool, It first, std::size_t n, Pred &pred) {
+    auto chunks = compaction_chunks(n, concurrency(pool));
+    auto offsets = count_by_chunk(pool, first, chunks, pred);
+    auto trues = offsets.back();
+
+    auto scratch = scratch_vector<iter_value_t<It>>(n, scratch_resource(pool));
+    run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        auto t = offsets[c];
+        auto f = trues + chunks.bound(c) - offsets[c];
+        for (auto i = chunks.bound(c); i != chunks.bound(c + 1); ++i)
+            scratch[pred(first[i]) ? t++ : f++] = std::move(first[i]);
+    });
+    run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        for (auto i = chunks.bound(c); i != chunks.bound(c + 1); ++i)
+            first[i] = std::move(scratch[i]);
+    });
+    return trues;
+}
+} // namespace detail
+
+/* copies the elements satisfying pred, and returns the end of what it wrote */
+template <typename Pool, typename InRange, typename OutRange, typename Pred>
+auto parallel_copy_if(Pool &pool, InRange &&in_range, OutRange &&out_range, Pred pred) {
+    using std::begin;
+    using std::end;
+
+    auto first = begin(in_range);
+    auto out = begin(out_range);
+    auto chunks = detail::compaction_chunks(std::size_t(end(in_range) - first),
+                                            detail::concurrency(pool));
+    auto offsets = detail::count_by_chunk(pool, first, chunks, pred);
+
+    detail::run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        auto to = out + offsets[c];
+        for (auto i = chunks.bound(c); i != chunks.bound(c + 1); ++i)
+            if (pred(first[i])) {
+                *to = first[i];
+                ++to;
+            }
+    });
+    return out + offsets.back();
+}
+
+/* copies the elements satisfying pred to out_true and the others to out_false, and returns
+ * the ends of both
+ */
+template <typename Pool, typename InRange, typename OutRange1, typename OutRange2, typename Pred>
+auto parallel_partition_copy(Pool &pool, InRange &&in_range, OutRange1 &&out_true,
+                             OutRange2 &&out_false, Pred pred) {
+    using std::begin;
+    using std::end;
+
+    auto first = begin(in_range);
+    auto to_true = begin(out_true);
+    auto to_false = begin(out_false);
+    auto n = std::size_t(end(in_range) - first);
+    auto chunks = detail::compaction_chunks(n, detail::concurrency(pool));
+    auto offsets = detail::count_by_chunk(pool, first, chunks, pred);
+
+    detail::run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        auto t = to_true + offsets[c];
+        auto f = to_false + (chunks.bound(c) - offsets[c]);
+        for (auto i = chunks.bound(c); i != chunks.bound(c + 1); ++i) {
+            if (pred(first[i])) {
+                *t = first[i];
+                ++t;
+            } else {
+                *f = first[i];
+                ++f;
+            }
+        }
+    });
+    return std::make_pair(to_true + offsets.back(), to_false + (n - offsets.back()));
+}
+
+/* a stable partition; returns the start of the elements not satisfying pred */
+template <typename Pool, typename Range, typename Pred>
+auto parallel_partition(Pool &pool, Range &&range, Pred pred) {
+    using std::begin;
+    using std::end;
+
+    auto first = begin(range);
+    return first + detail::parallel_stable_partition(pool, first,
+                                                     std::size_t(end(range) - first), pred);
+}
+
+/* removes the elements satisfying pred, keeping the order of the others, and returns the new
+ * end; what is left past it is unspecified, as with std::remove_if
+ */
+template <typename Pool, typename Range, typename Pred>
+auto parallel_remove_if(Pool &pool, Range &&range, Pred pred) {
+    using std::begin;
+    using std::end;
+
+    auto first = begin(range);
+    auto keep = [&pred](auto &&x) { return !pred(std::forward<decltype(x)>(x)); };
+    auto chunks = detail::compaction_chunks(std::size_t(end(range) - first),
+                                            detail::concurrency(pool));
+    auto offsets = detail::count_by_chunk(pool, first, chunks, keep);
+
+    auto scratch = detail::scratch_vector<iter_value_t<decltype(first)>>(
+        offsets.back(), detail::scratch_resource(pool));
+    detail::run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        auto to = offsets[c];
+        for (auto i = chunks.bound(c); i != chunks.bound(c + 1); ++i)
+            if (keep(first[i]))
+                scratch[to++] = std::move(first[i]);
+    });
+
+    auto kept = detail::chunking(scratch.size(), chunks.chunks, 1);
+    detail::run_chunks(pool, kept.chunks, [&](std::size_t c) {
+        for (auto i = kept.bound(c); i != kept.bound(c + 1); ++i)
+            first[i] = std::move(scratch[i]);
+    });
+    return first + offsets.back();
+}
+
+/* parallel merge
+ *
+ * the output is cut into one piece per worker, and a binary search along each cut (the
+ * "merge path") finds how many of its elements come from either input; the pieces are then
+ * merged independently. ties go to in_range1 first, as in std::merge.
+ */
+namespace detail {
+/* how many of the first d elements of the merge of a and b come from a */
+template <typename It1, typename It2, typename Compare>
+std::size_t merge_path(It1 a, std::size_t n1, It2 b, std::size_t n2, std::size_t d,
+                       Compare &cmp) {
+    auto lo = d > n2 ? d - n2 : 0;
+    auto hi = std::min(d, n1);
+    while (lo < hi) {
+        auto mid = lo + (hi - lo) / 2;
+        if (!cmp(b[d - mid - 1], a[mid]))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+} // namespace detail
+
+template <typename Pool, typename InRange1, typename InRange2, typename OutRange,
+          typename Compare>
+auto parallel_merge(Pool &pool, InRange1 &&in_range1, InRange2 &&in_range2,
+                    OutRange &&out_range, Compare cmp) {
+    using std::begin;
+    using std::end;
+
+    auto a = begin(in_range1);
+    auto b = begin(in_range2);
+    auto out = begin(out_range);
+    auto n1 = std::size_t(end(in_range1) - a);
+    auto n2 = std::size_t(end(in_range2) - b);
+    auto chunks = detail::chunking(n1 + n2, detail::concurrency(pool), std::size_t(1) << 14);
+
+    detail::run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        auto d0 = chunks.bound(c), d1 = chunks.bound(c + 1);
+        auto i0 = detail::merge_path(a, n1, b, n2, d0, cmp);
+        auto i1 = detail::merge_path(a, n1, b, n2, d1, cmp);
+        std::merge(a + i0, a + i1, b + (d0 - i0), b + (d1 - i1), out + d0, cmp);
+    });
+    return out + (n1 + n2);
+}
+
+template <typename Pool, typename InRange1, typename InRange2, typename OutRange>
+auto parallel_merge(Pool &pool, InRange1 &&in_range1, InRange2 &&in_range2,
+                    OutRange &&out_range) {
+    return drift::parallel_merge(pool, std::forward<InRange1>(in_range1),
+                                 std::forward<InRange2>(in_range2),
+                                 std::forward<OutRange>(out_range), std::less<>());
+}
+
+/* parallel sort
+ *
+ * a parallel merge sort: one run per worker is sorted with std::sort (or std::stable_sort),
+ * and then pairs of runs are merged in rounds, every merge cut into pieces along its merge
+ * path so that all workers stay busy until the last one. it needs a buffer as large as the
+ * range. ranges whose iterators return proxies, like zips, are sorted as a vector of their
+ * value_type and moved back, so cmp has to take value_types.
+ */
+namespace detail {
+template <typename It>
+constexpr bool has_proxy_reference = !std::is_same_v<iter_reference_t<It>, iter_value_t<It> &>;
+
+template <bool stable, typename Pool, typename It, typename Compare>
+void parallel_sort_impl(Pool &pool, It first, std::size_t n, Compare &cmp) {
+    auto workers = std::size_t(concurrency(pool));
+    auto runs = chunking(n, workers, std::size_t(1) << 14);
+    auto sort = [&cmp](auto lo, auto hi) {
+        if constexpr (stable)
+            std::stable_sort(lo, hi, cmp);
+        else
+            std::sort(lo, hi, cmp);
+    };
+    if (runs.chunks == 1)
+        return sort(first, first + n);
+
+    run_chunks(pool, runs.chunks, [&](std::size_t c) {
+        sort(first + runs.bound(c), first + runs.bound(c + 1));
+    });
+
+    /* merges [lo + i0, lo + i1) of the left run with [mid + j0, mid + j1) of the right one */
+    struct piece {
+        std::size_t lo, mid, i0, i1, j0, j1;
+    };
+    auto bounds = std::vector<std::size_t>();
+    for (std::size_t c = 0; c <= runs.chunks; ++c)
+        bounds.push_back(runs.bound(c));
+
+    auto buffer = scratch_vector<iter_value_t<It>>(n, scratch_resource(pool));
+    auto merge_round = [&](auto src, auto dst) {
+        auto pieces = std::vector<piece>();
+        auto next = std::vector<std::size_t>{0};
+        for (std::size_t r = 0; r + 1 < bounds.size(); r += 2) {
+            /* an odd run out is merged with nothing, which moves it across */
+            auto lo = bounds[r], mid = bounds[r + 1];
+            auto hi = r + 2 < bounds.size() ? bounds[r + 2] : mid;
+            /* the cuts are found before any piece starts moving elements out of src */
+            auto cuts = std::max<std::size_t>(1, (hi - lo) * workers / n);
+            auto i0 = std::size_t(0);
+            for (std::size_t c = 1; c <= cuts; ++c) {
+                auto d = (hi - lo) * c / cuts;
+                auto i1 = merge_path(src + lo, mid - lo, src + mid, hi - mid, d, cmp);
+                auto d0 = (hi - lo) * (c - 1) / cuts;
+                pieces.push_back({lo, mid, i0, i1, d0 - i0, d - i1});
+                i0 = i1;
+            }
+            next.push_back(hi);
+        }
+        run_chunks(pool, pieces.size(), [&](std::size_t k) {
+            auto [lo, mid, i0, i1, j0, j1] = pieces[k];
+            auto a = src + lo, b = src + mid;
+            std::merge(std::make_move_iterator(a + i0), std::make_move_iterator(a + i1),
+                       std::make_move_iterator(b + j0), std::make_move_iterator(b + j1),
+                       dst + lo + i0 + j0, cmp);
+        });
+        bounds = std::move(next);
+    };
+
+    auto in_buffer = false;
+    while (bounds.size() > 2) {
+        if (in_buffer)
+            merge_round(buffer.begin(), first);
+        else
+            merge_round(first, buffer.begin());
+        in_buffer = !in_buffer;
+    }
+    if (in_buffer) {
+        run_chunks(pool, runs.chunks, [&](std::size_t c) {
+            std::move(buffer.begin() + runs.bound(c), buffer.begin() + runs.bound(c + 1),
+                      first + runs.bound(c));
+        });
+    }
+}
+
+template <bool stable, typename Pool, typename Range, typename Compare>
+void parallel_sort(Pool &pool, Range &range, Compare &cmp) {
+    using std::begin;
+    using std::end;
+
+    auto first = begin(range);
+    static_assert(is_random_access<iterator_category_t<decltype(first)>>,
+                  "parallel sorts need random access ranges");
+    auto n = std::size_t(end(range) - first);
+
+    if constexpr (has_proxy_reference<decltype(first)>) {
+        auto values = scratch_vector<iter_value_t<decltype(first)>>(first, first + n,
+                                                                    scratch_resource(pool));
+        parallel_sort_impl<stable>(pool, values.begin(), n, cmp);
+        auto chunks = chunking(n, concurrency(pool), std::size_t(1) << 14);
+        run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+            for (auto i = chunks.bound(c); i != chunks.bound(c + 1); ++i)
+                first[i] = std::move(values[i]);
+        });
+    } else {
+        parallel_sort_impl<stable>(pool, first, n, cmp);
+    }
+}
+} // namespace detail
+
+template <typename Pool, typename Range, typename Compare>
+void parallel_sort(Pool &pool, Range &&range, Compare cmp) {
+    detail::parallel_sort<false>(pool, range, cmp);
+}
+
+template <typename Pool, typename Range>
+void parallel_sort(Pool &pool, Range &&range) {
+    drift::parallel_sort(pool, std::forward<Range>(range), std::less<>());
+}
+
+/* elements that compare equal keep their relative order */
+template <typename Pool, typename Range, typename Compare>
+void parallel_stable_sort(Pool &pool, Range &&range, Compare cmp) {
+    detail::parallel_sort<true>(pool, range, cmp);
+}
+
+template <typename Pool, typename Range>
+void parallel_stable_sort(Pool &pool, Range &&range) {
+    drift::parallel_stable_sort(pool, std::forward<Range>(range), std::less<>());
+}
+
+/* summaries
+ *
+ * summarize(range) computes the count, sum, min, max, mean and variance of a range of numbers
+ * in a single pass, and summarize(zip(columns...)) does it for every column at once. rows are
+ * read a block at a time into per-column buffers small enough to stay in cache, and every
+ * statistic is folded over a block, in vectorizable lanes, before the next one is read; blocks
+ * are then combined with the pairwise update of chan, golub and leveque, which keeps the
+ * variance accurate. the template argument is a mask of drift::stats saying what to compute;
+ * the rest is skipped and left at zero.
+ */
+namespace stats {
+enum : unsigned {
+    count = 1u << 0,
+    sum = 1u << 1,
+    min = 1u << 2,
+    max = 1u << 3,
+    mean = 1u << 4,
+    variance = 1u << 5,
+    all = (1u << 6) - 1,
+};
+} // namespace stats
+
+namespace detail {
+/* sums are kept in double, or in 64 bits for integers */
+template <typename T>
+using summary_sum_t =
+    std::conditional_t<std::is_floating_point_v<T>, std::common_type_t<T, double>,
+                       std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+constexpr bool needs_sum(unsigned mask) {
+    return mask & (stats::sum | stats::mean | stats::variance);
+}
+} // namespace detail
+
+/* the count is always there; min and max are nan if there were nans */
+template <typename T, unsigned Stats = stats::all>
+struct summary {
+    static_assert(std::is_arithmetic_v<T> and !std::is_same_v<T, bool>,
+                  "only numbers can be summarized");
+
+    std::size_t count = 0;
+    detail::summary_sum_t<T> sum = 0;
+    T min = T();
+    T max = T();
+    /* the sum of squared differences from the mean */
+    double m2 = 0;
+
+    double mean() const { return double(sum) / double(count); }
+    double variance() const { return m2 / double(count); }
+    double sample_variance() const { return m2 / double(count - 1); }
+
+    /* adds the summary of more elements */
+    summary &operator+=(const summary &other) {
+        if (other.count == 0)
+            return *this;
+        if (count == 0)
+            return *this = other;
+
+        if constexpr (bool(Stats & stats::min)) {
+            if (other.min < min or other.min != other.min)
+                min = other.min;
+        }
+        if constexpr (bool(Stats & stats::max)) {
+            if (max < other.max or other.max != other.max)
+                max = other.max;
+        }
+        if constexpr (bool(Stats & stats::variance)) {
+            auto n1 = double(count), n2 = double(other.count);
+            auto delta = other.mean() - mean();
+            m2 += other.m2 + delta * delta * n1 * n2 / (n1 + n2);
+        }
+        if constexpr (detail::needs_sum(Stats))
+            sum += other.sum;
+        count += other.count;
+        return *this;
+    }
+};
+
+namespace detail {
+template <typename T>
+constexpr bool is_tuple = false;
+
+template <typename... Ts>
+constexpr bool is_tuple<std::tuple<Ts...>> = true;
+
+/* rows of tuples have one column per element, other rows are a single column */
+template <typename T>
+struct columns_of {
+    using type = std::tuple<T>;
+};
+
+template <typename... Ts>
+struct columns_of<std::tuple<Ts...>> {
+    using type = std::tuple<Ts...>;
+};
+
+template <std::size_t I, typename Row>
+decltype(auto) column(Row &row) {
+    if constexpr (is_tuple<std::remove_cv_t<Row>>)
+        return std::get<I>(row);
+    else
+        return (row);
+}
+
+constexpr std::size_t summary_block = 1024;
+
+/* the summary of p[0], ..., p[n - 1], for n > 0 */
+template <unsigned Stats, typename T>
+summary<T, Stats> summarize_block(const T *p, std::size_t n) {
+    using sum_type = summary_sum_t<T>;
+    auto s = summary<T, Stats>();
+    s.count = n;
+    auto plus = std::plus<>();
+
+    if constexpr (needs_sum(Stats))
+        s.sum = unseq_fold(std::ptrdiff_t(n), sum_type(0), plus,
+                           [p](std::ptrdiff_t i) { return sum_type(p[i]); });
+    if constexpr (simd::is_vectorizable<T> and bool(Stats & (stats::min | stats::max))) {
+        auto e = simd::minmax(p, n);
+        if (e.unordered)
+            e.min = e.max = std::numeric_limits<T>::quiet_NaN();
+        s.min = e.min;
+        s.max = e.max;
+    } else {
+        if constexpr (bool(Stats & stats::min)) {
+            auto lesser = [](T a, T b) { return b < a ? b : a; };
+            s.min = unseq_fold(std::ptrdiff_t(n - 1), p[0], lesser,
+                               [p](std::ptrdiff_t i) { return p[i + 1]; });
+        }
+        if constexpr (bool(Stats & stats::max)) {
+            auto greater = [](T a, T b) { return a < b ? b : a; };
+            s.max = unseq_fold(std::ptrdiff_t(n - 1), p[0], greater,
+                               [p](std::ptrdiff_t i) { return p[i + 1]; });
+        }
+        if constexpr (std::is_floating_point_v<T> and bool(Stats & (stats::min | stats::max))) {
+            if (std::any_of(p, p + n, [](T x) { return x != x; }))
+                s.min = s.max = std::numeric_limits<T>::quiet_NaN();
+        }
+    }
+    if constexpr (bool(Stats & stats::variance)) {
+        auto mean = s.mean();
+        s.m2 = unseq_fold(std::ptrdiff_t(n), 0., plus, [p, mean](std::ptrdiff_t i) {
+            auto d = double(p[i]) - mean;
+            return d * d;
+        });
+    }
+    return s;
+}
+
+/* a tuple with the summary of every column of [first, last) */
+template <unsigned Stats, typename It, typename... Ts, std::size_t... I>
+std::tuple<summary<Ts, Stats>...> summarize_columns(It first, It last, std::tuple<Ts...> *,
+                                                    std::index_sequence<I...>) {
+    auto buffers = std::tuple<std::vector<Ts>...>(std::vector<Ts>(summary_block)...);
+    auto result = std::tuple<summary<Ts, Stats>...>();
+    while (first != last) {
+        std::size_t n = 0;
+        if constexpr (is_random_access<iterator_category_t<It>>) {
+            n = std::min(summary_block, std::size_t(last - first));
+            for (std::size_t i = 0; i != n; ++i) {
+                auto &&row = first[std::ptrdiff_t(i)];
+                ((std::get<I>(buffers)[i] = column<I>(row)), ...);
+            }
+            first += std::ptrdiff_t(n);
+        } else {
+            for (; n != summary_block and first != last; ++n, ++first) {
+                auto &&row = *first;
+                ((std::get<I>(buffers)[n] = column<I>(row)), ...);
+            }
+        }
+        ((std::get<I>(result) += summarize_block<Stats>(std::get<I>(buffers).data(), n)), ...);
+    }
+    return result;
+}
+
+template <unsigned Stats, typename It>
+auto summarize_columns(It first, It last) {
+    using columns = typename columns_of<iter_value_t<It>>::type;
+    return summarize_columns<Stats>(first, last, static_cast<columns *>(nullptr),
+                                    std::make_index_sequence<std::tuple_size_v<columns>>());
+}
+
+/* a summary for plain ranges, a tuple of them for ranges of tuples */
+template <typename It, typename Summaries>
+auto summaries_of(Summaries &&summaries) {
+    if constexpr (is_tuple<iter_value_t<It>>)
+        return std::forward<Summaries>(summaries);
+    else
+        return std::get<0>(std::forward<Summaries>(summaries));
+}
+} // namespace detail
+
+template <unsigned Stats = stats::all, typename InRange>
+auto summarize(InRange &&in_range) {
+    using std::begin;
+    using std::end;
+
+    auto first = begin(in_range);
+    return detail::summaries_of<decltype(first)>(
+        detail::summarize_columns<Stats>(first, end(in_range)));
+}
+
+/* summarizes one piece of the range per worker and adds the summaries up */
+template <unsigned Stats = stats::all, typename Pool, typename InRange>
+auto summarize(Pool &pool, InRange &&in_range) {
+    using std::begin;
+    using std::end;
+
+    auto first = begin(in_range);
+    using It = decltype(first);
+    static_assert(detail::is_random_access<iterator_category_t<It>>,
+                  "parallel summaries need random access ranges");
+    auto n = std::size_t(end(in_range) - first);
+    auto chunks = detail::chunking(n, detail::concurrency(pool), std::size_t(1) << 16);
+
+    using partial = decltype(detail::summarize_columns<Stats>(first, first));
+    auto partials = std::vector<partial>(chunks.chunks);
+    detail::run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        partials[c] = detail::summarize_columns<Stats>(first + chunks.bound(c),
+                                                       first + chunks.bound(c + 1));
+    });
+    for (std::size_t c = 1; c != chunks.chunks; ++c)
+        std::apply([&](auto &... total) {
+            std::apply([&](auto &... more) { ((total += more), ...); }, partials[c]);
+        }, partials[0]);
+    return detail::summaries_of<It>(std::move(partials[0]));
+}
+
+/* radix sort
+ *
+ * stable lsd radix sort on 8-bit digits, for integral and floating point keys. it needs a
+ * scratch copy of the range, and makes one counting pass plus one scatter pass for every
+ * digit on which the keys differ. floats are ordered as by operator<, except that -0.0 goes
+ * before 0.0 and nans go to the end with their sign's infinities.
+ *
+ * the pool overloads split the range into one chunk per worker: every chunk counts its own
+ * digits, and then scatters into its own slice of each bucket.
+ */
+namespace detail {
+template <typename T, typename = void>
+struct radix_key {};
+
+/* radix_key<T>::encode maps a T to an unsigned integer with the same order */
+template <typename T>
+struct radix_key<T, std::enable_if_t<std::is_integral_v<T> and !std::is_same_v<T, bool>>> {
+    using type = std::make_unsigned_t<T>;
+
+    static type encode(T t) {
+        if constexpr (std::is_signed_v<T>)
+            return type(type(t) ^ type(type(1) << (8 * sizeof(T) - 1)));
+        else
+            return t;
+    }
+};
+
+template <typename T>
+struct radix_key<T, std::enable_if_t<std::is_floating_point_v<T> and
+                                     (sizeof(T) == 4 or sizeof(T) == 8)>> {
+    using type = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+    static type encode(T t) {
+        type u;
+        std::memcpy(&u, &t, sizeof(T));
+        constexpr auto sign = type(type(1) << (8 * sizeof(T) - 1));
+        return (u & sign) ? type(~u) : type(u | sign);
+    }
+};
+
+template <typename T, typename = void>
+constexpr bool is_radix_sortable = false;
+
+template <typename T>
+constexpr bool is_radix_sortable<T, std::void_t<typename radix_key<T>::type>> = true;
+
+/* stands in for the value range of radix sorts without one */
+struct no_values {};
+
+using radix_histogram = std::array<std::size_t, 256>;
+
+template <typename K>
+unsigned radix_digit(const K &k, unsigned d) {
+    return unsigned(radix_key<K>::encode(k) >> (8 * d)) & 0xff;
+}
+
+template <typename KeyIt, typename ValueIt, typename DstKeyIt, typename DstValueIt>
+void radix_scatter(KeyIt keys, ValueIt values, DstKeyIt dst_keys, DstValueIt dst_values,
+                   std::size_t first, std::size_t last, unsigned d, radix_histogram &offsets) {
+    for (auto i = first; i != last; ++i) {
+        auto o = offsets[radix_digit(keys[i], d)]++;
+        dst_keys[o] = std::move(keys[i]);
+        if constexpr (!std::is_same_v<ValueIt, no_values>)
+            dst_values[o] = std::move(values[i]);
+    }
+}
+
+template <typename Pool, typename KeyIt, typename ValueIt>
+void radix_sort_impl(Pool &pool, KeyIt keys, ValueIt values, std::size_t n) {
+    using K = iter_value_t<KeyIt>;
+    static_assert(is_radix_sortable<K>, "radix sort needs integral or floating point keys");
+    constexpr bool has_values = !std::is_same_v<ValueIt, no_values>;
+    constexpr unsigned digits = sizeof(typename radix_key<K>::type);
+
+    if (n < 2)
+        return;
+
+    /* below this, a chunk's histograms cost more than its scatter saves */
+    constexpr std::size_t min_chunk = 1 << 16;
+    auto chunks = chunking(n, concurrency(pool), min_chunk);
+
+    /* every chunk counts all digits at once. the totals tell which digits are the same for
+     * every key and can be skipped; the per-chunk counts only hold until the first scatter.
+     */
+    auto hist = std::vector<std::array<radix_histogram, digits>>(chunks.chunks);
+    run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        for (auto &h : hist[c])
+            h.fill(0);
+        for (auto i = chunks.bound(c); i != chunks.bound(c + 1); ++i) {
+            auto u = radix_key<K>::encode(keys[i]);
+            for (unsigned d = 0; d != digits; ++d)
+                ++hist[c][d][unsigned(u >> (8 * d)) & 0xff];
+        }
+    });
+
+    auto key_buf = scratch_vector<K>(n, scratch_resource(pool));
+    auto value_buf = [&] {
+        if constexpr (has_values)
+            return scratch_vector<iter_value_t<ValueIt>>(n, scratch_resource(pool));
+        else
+            return no_values{};
+    }();
+    auto buf_values = [&] {
+        if constexpr (has_values)
+            return value_buf.begin();
+        else
+            return no_values{};
+    }();
+
+    auto offsets = std::vector<radix_histogram>(chunks.chunks);
+    auto in_buf = false, scattered = false;
+    for (unsigned d = 0; d != digits; ++d) {
+        auto uniform = false;
+        for (unsigned b = 0; b != 256 and !uniform; ++b) {
+            std::size_t total = 0;
+            for (auto &h : hist)
+                total += h[d][b];
+            uniform = total == n;
+        }
+        if (uniform)
+            continue;
+
+        if (scattered and chunks.chunks > 1) {
+            run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+                auto &h = hist[c][d];
+                h.fill(0);
+                for (auto i = chunks.bound(c); i != chunks.bound(c + 1); ++i)
+                    ++h[in_buf ? radix_digit(key_buf[i], d) : radix_digit(keys[i], d)];
+            });
+        }
+
+        /* bucket b of chunk c goes after the smaller buckets, and after bucket b of the
+         * chunks before c, which keeps the sort stable
+         */
+        std::size_t sum = 0;
+        for (unsigned b = 0; b != 256; ++b) {
+            for (std::size_t c = 0; c != chunks.chunks; ++c) {
+                offsets[c][b] = sum;
+                sum += hist[c][d][b];
+            }
+        }
+
+        run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+            auto first = chunks.bound(c), last = chunks.bound(c + 1);
+            if (in_buf)
+                radix_scatter(key_buf.begin(), buf_values, keys, values, first, last, d,
+                              offsets[c]);
+            else
+                radix_scatter(keys, values, key_buf.begin(), buf_values, first, last, d,
+                              offsets[c]);
+        });
+        in_buf = !in_buf;
+        scattered = true;
+    }
+
+    if (in_buf) {
+        std::move(key_buf.begin(), key_buf.end(), keys);
+        if constexpr (has_values)
+            std::move(value_buf.begin(), value_buf.end(), values);
+    }
+}
+
+template <typename Range>
+auto random_access_begin(Range &&range) {
+    using std::begin;
+    auto first = begin(range);
+    static_assert(is_random_access<iterator_category_t<decltype(first)>>,
+                  "radix sort needs random access ranges");
+    return first;
+}
+
+template <typename Range>
+std::size_t range_size(Range &&range) {
+    using std::begin;
+    using std::end;
+    return std::size_t(std::distance(begin(range), end(range)));
+}
+} // namespace detail
+
+template <typename Range>
+void radix_sort(Range &&range) {
+    auto pool = detail::no_pool();
+    detail::radix_sort_impl(pool, detail::random_access_begin(range), detail::no_values(),
+                            detail::range_size(range));
+}
+
+template <typename Pool, typename Range>
+void radix_sort(Pool &pool, Range &&range) {
+    detail::radix_sort_impl(pool, detail::random_access_begin(range), detail::no_values(),
+                            detail::range_size(range));
+}
+
+/* sorts 'keys', and moves the elements of 'values' along with them */
+template <typename KeyRange, typename ValueRange>
+void radix_sort_by_key(KeyRange &&keys, ValueRange &&values) {
+    auto pool = detail::no_pool();
+    detail::radix_sort_impl(pool, detail::random_access_begin(keys),
+                            detail::random_access_begin(values), detail::range_size(keys));
+}
+
+template <typename Pool, typename KeyRange, typename ValueRange>
+void radix_sort_by_key(Pool &pool, KeyRange &&keys, ValueRange &&values) {
+    detail::radix_sort_impl(pool, detail::random_access_begin(keys),
+                            detail::random_access_begin(values), detail::range_size(keys));
+}
+
+/* sorting parallel arrays
+ *
+ * sort_zipped(keys, payloads...) sorts 'keys' and applies the same reordering to every
+ * payload range, without going through zip_iterator's proxy references: the keys are sorted
+ * along with their row numbers -- radix sorted when they are integral or floating point, as
+ * compact (key, row) pairs otherwise -- and each payload is then gathered once through the
+ * resulting permutation.
+ */
+namespace detail {
+template <typename Key, typename Index>
+struct keyed_row {
+    Key key;
+    Index row;
+};
+
+template <typename Range, typename Index>
+void gather(Range &&range, const std::vector<Index> &rows) {
+    using std::begin;
+    using T = iter_value_t<decltype(begin(range))>;
+
+    auto first = begin(range);
+    auto scratch = std::vector<T>();
+    scratch.reserve(rows.size());
+    for (auto r : rows)
+        scratch.push_back(std::move(first[r]));
+    std::move(scratch.begin(), scratch.end(), first);
+}
+
+template <typename Index, bool stable, typename KeyRange, typename... PayloadRanges>
+void sort_zipped_impl(KeyRange &&keys, PayloadRanges &&...payloads) {
+    using std::begin;
+    using std::end;
+    using Key = iter_value_t<decltype(begin(keys))>;
+
+    auto first = begin(keys);
+    auto n = std::size_t(std::distance(first, end(keys)));
+
+    auto rows = std::vector<Index>(n);
+    if constexpr (is_radix_sortable<Key>) {
+        /* lsd radix sort is stable either way */
+        std::iota(rows.begin(), rows.end(), Index(0));
+        radix_sort_by_key(keys, rows);
+    } else {
+        auto pairs = std::vector<keyed_row<Key, Index>>();
+        pairs.reserve(n);
+        for (std::size_t i = 0; i != n; ++i)
+            pairs.push_back({std::move(first[i]), Index(i)});
+
+        /* breaking ties by row makes an unstable sort stable, and is cheaper than stable_sort */
+        if constexpr (stable)
+            std::sort(pairs.begin(), pairs.end(), [](const auto &a, const auto &b) {
+                return a.key < b.key or (!(b.key < a.key) and a.row < b.row);
+            });
+        else
+            std::sort(pairs.begin(), pairs.end(),
+                      [](const auto &a, const auto &b) { return a.key < b.key; });
+
+        for (std::size_t i = 0; i != n; ++i) {
+            first[i] = std::move(pairs[i].key);
+            rows[i] = pairs[i].row;
+        }
+    }
+    (gather(std::forward<PayloadRanges>(payloads), rows), ...);
+}
+
+template <bool stable, typename KeyRange, typename... PayloadRanges>
+void sort_zipped_dispatch(KeyRange &&keys, PayloadRanges &&...payloads) {
+    using std::begin;
+    using std::end;
+
+    /* 32-bit row numbers keep the pairs small whenever they are enough */
+    if (std::size_t(std::distance(begin(keys), end(keys))) <= 0xffffffffu)
+        sort_zipped_impl<std::uint32_t, stable>(std::forward<KeyRange>(keys),
+                                                std::forward<PayloadRanges>(payloads)...);
+    else
+        sort_zipped_impl<std::size_t, stable>(std::forward<KeyRange>(keys),
+                                              std::forward<PayloadRanges>(payloads)...);
+}
+} // namespace detail
+
+template <typename KeyRange, typename... PayloadRanges>
+void sort_zipped(KeyRange &&keys, PayloadRanges &&...payloads) {
+    detail::sort_zipped_dispatch<false>(std::forward<KeyRange>(keys),
+                                        std::forward<PayloadRanges>(payloads)...);
+}
+
+/* rows with equal keys keep their relative order */
+template <typename KeyRange, typename... PayloadRanges>
+void stable_sort_zipped(KeyRange &&keys, PayloadRanges &&...payloads) {
+    detail::sort_zipped_dispatch<true>(std::forward<KeyRange>(keys),
+                                       std::forward<PayloadRanges>(payloads)...);
+}
+
+} // namespace drift
@@ -30,8 +30,21 @@
 
 #pragma once
 
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+#include <new>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <iterator>
+#include <optional>
+#include <stdexcept>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace driftmeta {
 /* Scott Meyers' TD trick */
@@ -142,8 +155,75 @@ public:
 template <typename... Its>
 using weakest_iterator_tag_t = typename weakest_iterator_tag<Its...>::type;
 
+/* keeps the views' range constructors from hijacking their copy and move constructors */
+template <typename Range, typename View>
+constexpr bool is_other_range = !std::is_same_v<std::remove_cv_t<std::remove_reference_t<Range>>, View>;
+
 } // namespace detail
 
+/* slice: a plain [begin, end) sub-range */
+template <typename It>
+class slice;
+
+namespace detail {
+template <typename It>
+std::pair<slice<It>, slice<It>> split_at(It first, It last, iter_difference_t<It> n) {
+    auto mid = first + n;
+    return {slice<It>(first, mid), slice<It>(mid, last)};
+}
+
+/* index of the end of a range, for views that can be walked back from their end */
+template <typename It>
+iter_difference_t<It> end_index(It first, It last) {
+    if constexpr (is_decrementable<iterator_category_t<It>>)
+        return std::distance(first, last);
+    else
+        return 0;
+}
+} // namespace detail
+
+template <typename It>
+class slice {
+public:
+    slice() = default;
+    explicit slice(It begin_, It end_) : begin_(begin_), end_(end_) {}
+
+    It begin() const { return begin_; }
+    It end() const { return end_; }
+    iter_difference_t<It> size() const { return std::distance(begin_, end_); }
+
+    /* splitting */
+    template <typename U = int,
+              std::enable_if_t<detail::is_random_access<iterator_category_t<It>>, U> = 0>
+    auto split(iter_difference_t<It> n) const {
+        return detail::split_at(begin_, end_, n);
+    }
+
+    template <typename U = int,
+              std::enable_if_t<detail::is_random_access<iterator_category_t<It>>, U> = 0>
+    auto split() const {
+        return split(size() / 2);
+    }
+
+private:
+    It begin_;
+    It end_;
+};
+
+/* splittable ranges: random access ranges that can be cut into two sub-ranges in O(1),
+ * splitting at an index n or, by default, in half. both halves are slices of the original
+ * iterators, so they keep everything the iterators carry along -- indexed() indices included.
+ */
+template <typename Range, typename = void>
+struct is_splittable : std::false_type {};
+
+template <typename Range>
+struct is_splittable<Range, std::void_t<decltype(std::declval<const Range &>().split())>>
+  : std::true_type {};
+
+template <typename Range>
+constexpr bool is_splittable_v = is_splittable<std::remove_reference_t<Range>>::value;
+
 /* zip iterator */
 template <typename... Its>
 class zip_iterator {
@@ -304,7 +384,8 @@ class zip {
 public:
     zip() = default;
 
-    template <typename... Ranges>
+    template <typename... Ranges,
+              std::enable_if_t<(detail::is_other_range<Ranges, zip> and ...), int> = 0>
     explicit zip(Ranges &&... ranges)
       : begin_(driftmeta::adl_begin(ranges)...), end_(driftmeta::adl_end(ranges)...) {}
 
@@ -313,6 +394,19 @@ public:
     zip_iterator<Its...> end() const { return end_; }
     iter_difference_t<zip_iterator<Its...>> size() const { return end_ - begin_; }
 
+    /* splitting */
+    template <typename U = int,
+              std::enable_if_t<detail::is_random_access<detail::weakest_iterator_tag_t<Its...>>, U> = 0>
+    auto split(iter_difference_t<zip_iterator<Its...>> n) const {
+        return detail::split_at(begin(), end(), n);
+    }
+
+    template <typename U = int,
+              std::enable_if_t<detail::is_random_access<detail::weakest_iterator_tag_t<Its...>>, U> = 0>
+    auto split() const {
+        return split(size() / 2);
+    }
+
 private:
     zip_iterator<Its...> begin_;
     zip_iterator<Its...> end_;
@@ -341,11 +435,11 @@ public:
 
     indexed_iterator() = default;
 
-    explicit indexed_iterator(It it) : it(it), begin_(it) {}
-    explicit indexed_iterator(It it, It begin_) : it(it), begin_(begin_) {}
+    explicit indexed_iterator(It it, difference_type i = 0) : it(it), i(i) {}
+    explicit indexed_iterator(It it, It begin_) : it(it), i(std::distance(begin_, it)) {}
 
     /* dereference */
-    reference operator*() const { return driftmeta::safe_forward_as_tuple(it - begin_, *it); }
+    reference operator*() const { return driftmeta::safe_forward_as_tuple(i, *it); }
 
     /* certain output iterators don't return 'reference' */
     // decltype(auto) operator*() { return std::make_pair(begin_ - it, *it); }
@@ -358,10 +452,11 @@ public:
     /* increment */
     indexed_iterator &operator++() {
         ++it;
+        ++i;
         return *this;
     }
 
-    indexed_iterator &operator++(int) {
+    indexed_iterator operator++(int) {
         auto temp = *this;
         ++(*this);
         return temp;
@@ -370,6 +465,7 @@ public:
     template <typename U = int, std::enable_if_t<detail::is_decrementable<iterator_category>, U> = 0>
     indexed_iterator &operator--() {
         --it;
+        --i;
         return *this;
     }
 
@@ -384,12 +480,14 @@ public:
     template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
     indexed_iterator &operator+=(difference_type n) {
         it += n;
+        i += n;
         return *this;
     }
 
     template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
     indexed_iterator &operator-=(difference_type n) {
         it -= n;
+        i -= n;
         return *this;
     }
 
@@ -416,7 +514,7 @@ public:
 
     /* comparison */
     friend bool operator==(const indexed_iterator &lhs, const indexed_iterator &rhs) {
-        return (lhs.it == rhs.it); // and (lhs.begin_ == rhs.begin_);
+        return lhs.it == rhs.it;
     }
     friend bool operator!=(const indexed_iterator &lhs, const indexed_iterator &rhs) {
         return !(lhs == rhs);
@@ -445,7 +543,8 @@ public:
 
 
 private:
-    It it, begin_;
+    It it;
+    difference_type i = 0;
 };
 
 template <typename It>
@@ -453,14 +552,29 @@ class indexed {
 public:
     indexed() = default;
 
-    template <typename Range>
+    template <typename Range, std::enable_if_t<detail::is_other_range<Range, indexed>, int> = 0>
     explicit indexed(Range &&range)
-      : begin_(driftmeta::adl_begin(range)), end_(driftmeta::adl_end(range)) {}
+      : begin_(driftmeta::adl_begin(range)),
+        end_(driftmeta::adl_end(range),
+             detail::end_index(driftmeta::adl_begin(range), driftmeta::adl_end(range))) {}
 
     indexed_iterator<It> begin() const { return begin_; }
     indexed_iterator<It> end() const { return end_; }
     iter_difference_t<It> size() const { return end_ - begin_; }
 
+    /* splitting */
+    template <typename U = int,
+              std::enable_if_t<detail::is_random_access<iterator_category_t<It>>, U> = 0>
+    auto split(iter_difference_t<indexed_iterator<It>> n) const {
+        return detail::split_at(begin(), end(), n);
+    }
+
+    template <typename U = int,
+              std::enable_if_t<detail::is_random_access<iterator_category_t<It>>, U> = 0>
+    auto split() const {
+        return split(size() / 2);
+    }
+
 private:
     indexed_iterator<It> begin_;
     indexed_iterator<It> end_;
@@ -470,76 +584,416 @@ template <typename Range>
 indexed(Range &&range)->indexed<decltype(driftmeta::adl_begin(range))>;
 
 /* generator */
+namespace detail {
+template <typename T>
+struct generated {
+    using type = T;
+    static constexpr bool is_optional = false;
+};
+
+template <typename T>
+struct generated<std::optional<T>> {
+    using type = T;
+    static constexpr bool is_optional = true;
+};
+
+/* producers may also provide a bulk overload, gen(first, n) -> number of values written */
+template <typename Gen, typename T, typename = void>
+constexpr bool has_bulk_call = false;
+
+template <typename Gen, typename T>
+constexpr bool has_bulk_call<
+    Gen, T, std::enable_if_t<std::is_invocable_r_v<std::size_t, Gen &, T *, std::size_t>>> = true;
+
+template <typename Range, typename = void>
+constexpr bool has_data = false;
+
+template <typename Range>
+constexpr bool has_data<Range, std::void_t<decltype(std::data(std::declval<Range &>()))>> = true;
+} // namespace detail
+
+/* drift::generator<F> wraps a nullary callable F; drift::generator<T>, for any T that
+ * isn't callable, is a coroutine yielding T's (C++20 only).
+ */
+template <typename T, typename = void>
+class generator;
+
+/* generator iterator: a handle to its generator's current value */
 template <typename Gen>
 class generator_iterator {
 public:
     /* usual iterator typedefs */
     using difference_type = std::ptrdiff_t;
-    using value_type = std::invoke_result_t<Gen>;
+    using value_type = typename generator<Gen>::value_type;
     using pointer = value_type *;
-    using reference = value_type;
+    using reference = value_type &;
     using iterator_category = std::input_iterator_tag;
 
     generator_iterator() = default;
-    explicit generator_iterator(Gen gen)
-      : gen(gen) //, result{gen()}
-    {}
+    explicit generator_iterator(generator<Gen> *gen) : gen(gen) {}
 
     /* dereference */
-    // reference operator*() const { return result; }
-    reference operator*() { return gen(); }
+    reference operator*() const { return *gen->value_; }
+    pointer operator->() const { return &*gen->value_; }
 
     /* increment */
-    // generator_iterator &operator++() { result = gen(); }
-    generator_iterator &operator++() { return *this; }
+    generator_iterator &operator++() {
+        if (!gen->advance())
+            gen = nullptr;
+        return *this;
+    }
 
-    generator_iterator &operator++(int) {
-        auto temp = *this;
+    /* keeps *it++ meaningful: the old value outlives the increment */
+    class postfix_proxy {
+    public:
+        explicit postfix_proxy(value_type v) : v(std::move(v)) {}
+        value_type &operator*() { return v; }
+
+    private:
+        value_type v;
+    };
+
+    postfix_proxy operator++(int) {
+        auto temp = postfix_proxy(std::move(**this));
         ++(*this);
         return temp;
     }
 
     /* comparison */
     friend bool operator==(const generator_iterator &lhs, const generator_iterator &rhs) {
-        return (&lhs.gen == &rhs.gen); // and (lhs.result == rhs.result);
+        return lhs.gen == rhs.gen;
     }
     friend bool operator!=(const generator_iterator &lhs, const generator_iterator &rhs) {
         return !(lhs == rhs);
     }
 
 private:
-    Gen gen;
-    // value_type result;
+    generator<Gen> *gen = nullptr;
 };
 
-/* generating input iterator */
-template <typename It>
-class generator {
-public:
-    generator() = default;
+/* generator: an input range over the values of a nullary callable.
+ *
+ * each value is produced once, when the range is started or its iterator incremented, and
+ * cached until the next increment. a callable returning std::optional<T> ends the range by
+ * returning std::nullopt; one returning plain values makes an endless range (see until()).
+ */
+template <typename Gen>
+class generator<Gen, std::enable_if_t<std::is_invocable_v<Gen &>>> {
+    using result_t = std::invoke_result_t<Gen &>;
 
-    template <typename Gen>
-    explicit generator( // typename generator_iterator<Gen>::value_type begin_,
-                        // typename generator_iterator<Gen>::value_type end_,
-        Gen &&gen)
-      : begin_(gen) {}
+public:
+    using value_type = typename detail::generated<result_t>::type;
+    using iterator = generator_iterator<Gen>;
 
-    It begin() { return begin_; }
-    It end() { return begin_; }
+    generator() = default;
+    explicit generator(Gen gen) : gen_(std::move(gen)) {}
+
+    iterator begin() {
+        if (!started_) {
+            started_ = true;
+            advance();
+        }
+        return value_ ? iterator(this) : iterator();
+    }
+    iterator end() { return iterator(); }
+
+    /* fills 'buffer' with the next values in one go and returns how many were written, fewer
+     * than the buffer's size only if the range ended. a value already fetched by begin() or
+     * an increment comes first. iterators into the generator are invalidated.
+     */
+    template <typename OutRange>
+    std::size_t next_n(OutRange &&buffer) {
+        using std::begin;
+        using std::end;
+
+        auto first = begin(buffer);
+        auto last = end(buffer);
+        std::size_t n = 0;
+
+        if (value_ and first != last) {
+            *first = std::move(*value_);
+            ++first;
+            ++n;
+        }
+        value_.reset();
+        started_ = false;
+
+        if constexpr (detail::has_bulk_call<Gen, value_type> and detail::has_data<OutRange>) {
+            auto size = std::size_t(std::distance(first, last));
+            return n + std::invoke(gen_, std::data(buffer) + n, size);
+        } else {
+            for (; first != last; ++first, ++n) {
+                if constexpr (detail::generated<result_t>::is_optional) {
+                    auto r = std::invoke(gen_);
+                    if (!r)
+                        break;
+                    *first = std::move(*r);
+                } else {
+                    *first = std::invoke(gen_);
+                }
+            }
+            return n;
+        }
+    }
 
 private:
-    It begin_; // end_;
+    friend iterator;
+
+    Gen gen_;
+    std::optional<value_type> value_;
+    bool started_ = false;
+
+    bool advance() {
+        if constexpr (detail::generated<result_t>::is_optional) {
+            auto r = std::invoke(gen_);
+            if (!r) {
+                value_.reset();
+                return false;
+            }
+            value_ = std::move(*r);
+        } else {
+            value_ = std::invoke(gen_);
+        }
+        return true;
+    }
 };
 
 template <typename Gen>
-generator(Gen &&)->generator<generator_iterator<Gen>>;
+generator(Gen &&)->generator<std::decay_t<Gen>>;
+
+/* turns an endless producer into one that ends at the first value equal to 'sentinel' */
+template <typename Gen, typename T>
+auto until(Gen &&gen, T sentinel) {
+    return [gen = std::forward<Gen>(gen), sentinel = std::move(sentinel)]() mutable {
+        auto v = std::invoke(gen);
+        return v == sentinel ? std::nullopt : std::optional<decltype(v)>(std::move(v));
+    };
+}
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+namespace detail {
+/* recycles coroutine frames through per-thread free lists, one per 64-byte size class, so
+ * that short-lived generators don't hit the global heap. frames freed on another thread
+ * go to that thread's lists. larger frames fall through to ::operator new.
+ */
+class frame_pool {
+    struct node {
+        node *next;
+    };
+
+    static constexpr std::size_t granularity = 64;
+    static constexpr std::size_t n_classes = 16;
+    static constexpr std::size_t max_cached = 64;
+
+    node *free_[n_classes] = {};
+    std::size_t cached_[n_classes] = {};
+
+    enum class state : unsigned char { unborn, alive, dead };
+    static state &local_state() noexcept {
+        static thread_local state s = state::unborn;
+        return s;
+    }
+
+    frame_pool() noexcept { local_state() = state::alive; }
+
+    /* null once the thread's pool is gone, e.g. for frames freed during thread exit */
+    static frame_pool *local() noexcept {
+        if (local_state() == state::dead)
+            return nullptr;
+        static thread_local frame_pool pool;
+        return &pool;
+    }
+
+    static std::size_t size_class(std::size_t n) noexcept { return (n - 1) / granularity; }
+
+public:
+    frame_pool(const frame_pool &) = delete;
+    frame_pool &operator=(const frame_pool &) = delete;
+
+    ~frame_pool() {
+        local_state() = state::dead;
+        for (auto &head : free_) {
+            while (head) {
+                auto next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+    }
+
+    static void *allocate(std::size_t n) {
+        auto c = size_class(n);
+        auto pool = local();
+        if (c >= n_classes or !pool)
+            return ::operator new(n);
+
+        if (auto head = pool->free_[c]) {
+            pool->free_[c] = head->next;
+            --pool->cached_[c];
+            return head;
+        }
+        return ::operator new((c + 1) * granularity);
+    }
+
+    static void deallocate(void *p, std::size_t n) noexcept {
+        auto c = size_class(n);
+        auto pool = local();
+        if (c >= n_classes or !pool or pool->cached_[c] == max_cached) {
+            ::operator delete(p);
+            return;
+        }
+        pool->free_[c] = ::new (p) node{pool->free_[c]};
+        ++pool->cached_[c];
+    }
+};
+} // namespace detail
+
+/* coroutine generator: an input range over the values a coroutine co_yields.
+ *
+ *     drift::generator<int> iota(int n) {
+ *         while (true)
+ *             co_yield n++;
+ *     }
+ *
+ * the body runs up to its first co_yield when the range is started, and on to the next one
+ * on each increment. the range ends when the coroutine returns.
+ */
+template <typename T>
+class generator<T, std::enable_if_t<!std::is_invocable_v<T &>>> {
+public:
+    using value_type = std::remove_cv_t<std::remove_reference_t<T>>;
+
+    class promise_type {
+    public:
+        generator get_return_object() noexcept {
+            return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        /* yielded lvalues and temporaries are referred to in place; they outlive the
+         * suspension. anything else is converted into the awaiter, which does too.
+         */
+        std::suspend_always yield_value(value_type &v) noexcept {
+            value_ = std::addressof(v);
+            return {};
+        }
+        std::suspend_always yield_value(value_type &&v) noexcept {
+            value_ = std::addressof(v);
+            return {};
+        }
+
+        template <typename U,
+                  std::enable_if_t<!std::is_same_v<std::remove_cv_t<std::remove_reference_t<U>>, value_type> or
+                                       std::is_const_v<std::remove_reference_t<U>>,
+                                   int> = 0>
+        auto yield_value(U &&u) noexcept(std::is_nothrow_constructible_v<value_type, U>) {
+            struct owning_awaiter : std::suspend_always {
+                value_type v;
+                promise_type *promise;
+                void await_suspend(std::coroutine_handle<>) noexcept { promise->value_ = &v; }
+            };
+            return owning_awaiter{{}, value_type(std::forward<U>(u)), this};
+        }
+
+        void return_void() noexcept {}
+        void unhandled_exception() { exception_ = std::current_exception(); }
+
+        /* no co_await inside generators */
+        template <typename U>
+        std::suspend_never await_transform(U &&) = delete;
+
+        static void *operator new(std::size_t n) { return detail::frame_pool::allocate(n); }
+        static void operator delete(void *p, std::size_t n) noexcept {
+            detail::frame_pool::deallocate(p, n);
+        }
+
+    private:
+        friend generator;
+
+        value_type *value_ = nullptr;
+        std::exception_ptr exception_;
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    class iterator {
+    public:
+        /* usual iterator typedefs */
+        using difference_type = std::ptrdiff_t;
+        using value_type = generator::value_type;
+        using pointer = value_type *;
+        using reference = value_type &;
+        using iterator_category = std::input_iterator_tag;
+
+        iterator() = default;
+        explicit iterator(handle_type h) : h(h) {}
+
+        /* dereference */
+        reference operator*() const { return *h.promise().value_; }
+        pointer operator->() const { return h.promise().value_; }
+
+        /* increment */
+        iterator &operator++() {
+            resume(h);
+            if (h.done())
+                h = nullptr;
+            return *this;
+        }
+
+        void operator++(int) { ++(*this); }
+
+        /* comparison */
+        friend bool operator==(const iterator &lhs, const iterator &rhs) { return lhs.h == rhs.h; }
+        friend bool operator!=(const iterator &lhs, const iterator &rhs) { return !(lhs == rhs); }
+
+    private:
+        handle_type h = nullptr;
+    };
+
+    generator() = default;
+    generator(generator &&rhs) noexcept : h_(std::exchange(rhs.h_, nullptr)) {}
+    generator &operator=(generator rhs) noexcept {
+        std::swap(h_, rhs.h_);
+        return *this;
+    }
+    ~generator() {
+        if (h_)
+            h_.destroy();
+    }
+
+    iterator begin() {
+        if (!h_)
+            return iterator();
+        if (!started_) {
+            started_ = true;
+            resume(h_);
+        }
+        return h_.done() ? iterator() : iterator(h_);
+    }
+    iterator end() { return iterator(); }
+
+private:
+    handle_type h_ = nullptr;
+    bool started_ = false;
+
+    explicit generator(handle_type h) noexcept : h_(h) {}
+
+    static void resume(handle_type h) {
+        h.resume();
+        if (auto e = std::exchange(h.promise().exception_, nullptr))
+            std::rethrow_exception(e);
+    }
+};
+#endif
 
 template <typename RIt>
 class reverse_view {
 public:
     reverse_view() = default;
 
-    template <typename Range>
+    template <typename Range, std::enable_if_t<detail::is_other_range<Range, reverse_view>, int> = 0>
     explicit reverse_view(Range &&range)
       : begin_(std::make_reverse_iterator(driftmeta::adl_end(range))),
         end_(std::make_reverse_iterator(driftmeta::adl_begin(range))) {}
@@ -548,6 +1002,19 @@ public:
     RIt end() const { return end_; }
     iter_difference_t<RIt> size() const { return end_ - begin_; }
 
+    /* splitting */
+    template <typename U = int,
+              std::enable_if_t<detail::is_random_access<iterator_category_t<RIt>>, U> = 0>
+    auto split(iter_difference_t<RIt> n) const {
+        return detail::split_at(begin(), end(), n);
+    }
+
+    template <typename U = int,
+              std::enable_if_t<detail::is_random_access<iterator_category_t<RIt>>, U> = 0>
+    auto split() const {
+        return split(size() / 2);
+    }
+
 private:
     RIt begin_;
     RIt end_;
@@ -561,7 +1028,7 @@ class tail {
 public:
     tail() = default;
 
-    template <typename Range>
+    template <typename Range, std::enable_if_t<detail::is_other_range<Range, tail>, int> = 0>
     explicit tail(Range &&range, size_t n = 1)
       : begin_(std::next(driftmeta::adl_begin(range), n)), end_(driftmeta::adl_end(range)) {}
 
@@ -569,6 +1036,19 @@ public:
     It end() const { return end_; }
     iter_difference_t<It> size() const { return end_ - begin_; }
 
+    /* splitting */
+    template <typename U = int,
+              std::enable_if_t<detail::is_random_access<iterator_category_t<It>>, U> = 0>
+    auto split(iter_difference_t<It> n) const {
+        return detail::split_at(begin(), end(), n);
+    }
+
+    template <typename U = int,
+              std::enable_if_t<detail::is_random_access<iterator_category_t<It>>, U> = 0>
+    auto split() const {
+        return split(size() / 2);
+    }
+
 private:
     It begin_;
     It end_;
@@ -577,4 +1057,426 @@ private:
 template <typename Range>
 tail(Range &&range)->tail<decltype(driftmeta::adl_begin(range))>;
 
+template <typename Range>
+tail(Range &&range, size_t n)->tail<decltype(driftmeta::adl_begin(range))>;
+
+namespace detail {
+/* advances 'it' by up to n steps without going past 'end', returns the number of steps taken */
+template <typename It>
+iter_difference_t<It> bounded_advance(It &it, iter_difference_t<It> n, const It &end) {
+    if constexpr (is_random_access<iterator_category_t<It>>) {
+        auto step = std::min(n, iter_difference_t<It>(end - it));
+        it += step;
+        return step;
+    } else {
+        auto step = iter_difference_t<It>{0};
+        for (; step != n and it != end; ++step)
+            ++it;
+        return step;
+    }
+}
+
+/* returns n if it is at least 'least', throws otherwise */
+inline std::ptrdiff_t checked_extent(std::ptrdiff_t n, std::ptrdiff_t least, const char *what) {
+    if (n < least)
+        throw std::invalid_argument(what);
+    return n;
+}
+} // namespace detail
+
+/* chunk iterator: yields consecutive slices of n elements, the last one possibly shorter */
+template <typename It>
+class chunk_iterator {
+public:
+    /* usual iterator typedefs */
+    using difference_type = std::ptrdiff_t;
+    using value_type = slice<It>;
+    using pointer = void;
+    using reference = slice<It>;
+    using iterator_category = detail::weakest_iterator_tag_t<It>;
+
+    static_assert(std::is_base_of_v<std::forward_iterator_tag, iterator_category>,
+                  "chunking requires a multi-pass range");
+
+    chunk_iterator() = default;
+
+    /* 'missing' is how far short of a whole chunk 'it' fell when it was clamped to 'end' */
+    explicit chunk_iterator(It it, It end, difference_type n, difference_type missing = 0)
+      : it(it), end_(end), n(n), missing(missing) {}
+
+    /* dereference */
+    reference operator*() const {
+        auto last = it;
+        detail::bounded_advance(last, n, end_);
+        return slice<It>(it, last);
+    }
+
+    template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
+    reference operator[](difference_type k) const {
+        return *(*this + k);
+    }
+
+    /* increment */
+    chunk_iterator &operator++() {
+        missing = n - detail::bounded_advance(it, n, end_);
+        return *this;
+    }
+
+    chunk_iterator operator++(int) {
+        auto temp = *this;
+        ++(*this);
+        return temp;
+    }
+
+    /* decrement */
+    template <typename U = int, std::enable_if_t<detail::is_decrementable<iterator_category>, U> = 0>
+    chunk_iterator &operator--() {
+        std::advance(it, missing - n);
+        missing = 0;
+        return *this;
+    }
+
+    template <typename U = int, std::enable_if_t<detail::is_decrementable<iterator_category>, U> = 0>
+    chunk_iterator operator--(int) {
+        auto temp = *this;
+        --(*this);
+        return temp;
+    }
+
+    /* arithmetic */
+    template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
+    chunk_iterator &operator+=(difference_type k) {
+        if (k > 0) {
+            missing = k * n - detail::bounded_advance(it, k * n, end_);
+        } else if (k < 0) {
+            it += k * n + missing;
+            missing = 0;
+        }
+        return *this;
+    }
+
+    template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
+    chunk_iterator &operator-=(difference_type k) {
+        return *this += -k;
+    }
+
+    template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
+    friend chunk_iterator operator+(chunk_iterator lhs, difference_type k) {
+        return lhs += k;
+    }
+
+    template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
+    friend chunk_iterator operator+(difference_type k, chunk_iterator rhs) {
+        return rhs += k;
+    }
+
+    template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
+    friend chunk_iterator operator-(chunk_iterator lhs, difference_type k) {
+        return lhs -= k;
+    }
+
+    /* iterator subtraction */
+    template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
+    friend difference_type operator-(const chunk_iterator &lhs, const chunk_iterator &rhs) {
+        return (lhs.it - rhs.it + lhs.missing - rhs.missing) / lhs.n;
+    }
+
+    /* comparison */
+    friend bool operator==(const chunk_iterator &lhs, const chunk_iterator &rhs) {
+        return lhs.it == rhs.it;
+    }
+    friend bool operator!=(const chunk_iterator &lhs, const chunk_iterator &rhs) {
+        return !(lhs == rhs);
+    }
+
+    /* random access comparisons */
+    template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
+    friend bool operator<(const chunk_iterator &lhs, const chunk_iterator &rhs) {
+        return lhs.it < rhs.it;
+    }
+
+    template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
+    friend bool operator>(const chunk_iterator &lhs, const chunk_iterator &rhs) {
+        return lhs.it > rhs.it;
+    }
+
+    template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
+    friend bool operator<=(const chunk_iterator &lhs, const chunk_iterator &rhs) {
+        return lhs.it <= rhs.it;
+    }
+
+    template <typename U = int, std::enable_if_t<detail::is_random_access<iterator_category>, U> = 0>
+    friend bool operator>=(const chunk_iterator &lhs, const chunk_iterator &rhs) {
+        return lhs.it >= rhs.it;
+    }
+
+private:
+    It it, end_;
+    difference_type n = 1;
+    difference_type missing = 0;
+};
+
+/* chunk view: splits a range into consecutive sub-ranges of n elements */
+template <typename It>
+class chunk {
+public:
+    chunk() = default;
+
+    template <typename Range, std::enable_if_t<detail::is_other_range<Range, chunk>, int> = 0>
+    explicit chunk(Range &&range, std::ptrdiff_t n)
+      : begin_(driftmeta::adl_begin(range), driftmeta::adl_end(range),
+               detail::checked_extent(n, 1, "chunk size must be positive")),
+        end_(driftmeta::adl_end(range), driftmeta::adl_end(range), n,
+             end_missing(driftmeta::adl_begin(range), driftmeta::adl_end(range), n)) {}
+
+    chunk_iterator<It> begin() const { return begin_; }
+    chunk_iterator<It> end() const { return end_; }
+    iter_difference_t<chunk_iterator<It>> size() const { return end_ - begin_; }
+
+private:
+    chunk_iterator<It> begin_;
+    chunk_iterator<It> end_;
+
+    /* the end iterator only needs to know the size of the last chunk if it can walk back */
+    static std::ptrdiff_t end_missing(It first, It last, std::ptrdiff_t n) {
+        if constexpr (detail::is_decrementable<iterator_category_t<It>>) {
+            auto rem = std::distance(first, last) % n;
+            return rem == 0 ? 0 : n - rem;
+        } else {
+            return 0;
+        }
+    }
+};
+
+template <typename Range>
+chunk(Range &&range, std::ptrdiff_t n)->chunk<decltype(driftmeta::adl_begin(range))>;
+
+/* a single tile of a row-major 2d range, iterable as a sequence of row slices */
+template <typename It>
+class tile2d_block {
+    class row_iterator {
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = slice<It>;
+        using pointer = void;
+        using reference = slice<It>;
+        using iterator_category = std::random_access_iterator_tag;
+
+        row_iterator() = default;
+        explicit row_iterator(It first, difference_type row, difference_type width,
+                              difference_type stride)
+          : first(first), row(row), width(width), stride(stride) {}
+
+        /* rows are counted rather than stepped so the end never points past the range */
+        reference operator*() const {
+            auto it = first + row * stride;
+            return slice<It>(it, it + width);
+        }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        row_iterator &operator++() { return *this += 1; }
+        row_iterator operator++(int) {
+            auto temp = *this;
+            ++(*this);
+            return temp;
+        }
+        row_iterator &operator--() { return *this -= 1; }
+        row_iterator operator--(int) {
+            auto temp = *this;
+            --(*this);
+            return temp;
+        }
+
+        row_iterator &operator+=(difference_type n) {
+            row += n;
+            return *this;
+        }
+        row_iterator &operator-=(difference_type n) { return *this += -n; }
+        friend row_iterator operator+(row_iterator lhs, difference_type n) { return lhs += n; }
+        friend row_iterator operator+(difference_type n, row_iterator rhs) { return rhs += n; }
+        friend row_iterator operator-(row_iterator lhs, difference_type n) { return lhs -= n; }
+        friend difference_type operator-(const row_iterator &lhs, const row_iterator &rhs) {
+            return lhs.row - rhs.row;
+        }
+
+        friend bool operator==(const row_iterator &lhs, const row_iterator &rhs) {
+            return lhs.row == rhs.row;
+        }
+        friend bool operator!=(const row_iterator &lhs, const row_iterator &rhs) {
+            return !(lhs == rhs);
+        }
+        friend bool operator<(const row_iterator &lhs, const row_iterator &rhs) {
+            return lhs.row < rhs.row;
+        }
+        friend bool operator>(const row_iterator &lhs, const row_iterator &rhs) {
+            return lhs.row > rhs.row;
+        }
+        friend bool operator<=(const row_iterator &lhs, const row_iterator &rhs) {
+            return lhs.row <= rhs.row;
+        }
+        friend bool operator>=(const row_iterator &lhs, const row_iterator &rhs) {
+            return lhs.row >= rhs.row;
+        }
+
+    private:
+        It first;
+        difference_type row = 0;
+        difference_type width = 0;
+        difference_type stride = 1;
+    };
+
+public:
+    tile2d_block() = default;
+    explicit tile2d_block(It first, std::ptrdiff_t row, std::ptrdiff_t col, std::ptrdiff_t rows,
+                          std::ptrdiff_t cols, std::ptrdiff_t stride)
+      : first_(first), row_(row), col_(col), rows_(rows), cols_(cols), stride_(stride) {}
+
+    row_iterator begin() const { return row_iterator(first_, 0, cols_, stride_); }
+    row_iterator end() const { return row_iterator(first_, rows_, cols_, stride_); }
+    std::ptrdiff_t size() const { return rows_; }
+
+    /* position of the tile's top-left element in the whole range, and its extents */
+    std::ptrdiff_t row() const { return row_; }
+    std::ptrdiff_t col() const { return col_; }
+    std::ptrdiff_t rows() const { return rows_; }
+    std::ptrdiff_t cols() const { return cols_; }
+
+private:
+    It first_;
+    std::ptrdiff_t row_ = 0, col_ = 0;
+    std::ptrdiff_t rows_ = 0, cols_ = 0;
+    std::ptrdiff_t stride_ = 1;
+};
+
+/* tile iterator: walks the tiles of a row-major 2d range in row-major order */
+template <typename It>
+class tile2d_iterator {
+public:
+    /* usual iterator typedefs */
+    using difference_type = std::ptrdiff_t;
+    using value_type = tile2d_block<It>;
+    using pointer = void;
+    using reference = tile2d_block<It>;
+    using iterator_category = detail::weakest_iterator_tag_t<It>;
+
+    static_assert(detail::is_random_access<iterator_category>,
+                  "tiling requires a random access range");
+
+    tile2d_iterator() = default;
+    explicit tile2d_iterator(It first, difference_type rows, difference_type cols,
+                             difference_type tile, difference_type t = 0)
+      : first(first), rows(rows), cols(cols), tile(tile), tiles_per_row((cols + tile - 1) / tile),
+        t(t) {}
+
+    /* dereference */
+    reference operator*() const {
+        auto row = (t / tiles_per_row) * tile;
+        auto col = (t % tiles_per_row) * tile;
+        return tile2d_block<It>(first + row * cols + col, row, col, std::min(tile, rows - row),
+                                std::min(tile, cols - col), cols);
+    }
+
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    /* increment */
+    tile2d_iterator &operator++() {
+        ++t;
+        return *this;
+    }
+
+    tile2d_iterator operator++(int) {
+        auto temp = *this;
+        ++(*this);
+        return temp;
+    }
+
+    /* decrement */
+    tile2d_iterator &operator--() {
+        --t;
+        return *this;
+    }
+
+    tile2d_iterator operator--(int) {
+        auto temp = *this;
+        --(*this);
+        return temp;
+    }
+
+    /* arithmetic */
+    tile2d_iterator &operator+=(difference_type n) {
+        t += n;
+        return *this;
+    }
+
+    tile2d_iterator &operator-=(difference_type n) {
+        t -= n;
+        return *this;
+    }
+
+    friend tile2d_iterator operator+(tile2d_iterator lhs, difference_type n) { return lhs += n; }
+    friend tile2d_iterator operator+(difference_type n, tile2d_iterator rhs) { return rhs += n; }
+    friend tile2d_iterator operator-(tile2d_iterator lhs, difference_type n) { return lhs -= n; }
+
+    /* iterator subtraction */
+    friend difference_type operator-(const tile2d_iterator &lhs, const tile2d_iterator &rhs) {
+        return lhs.t - rhs.t;
+    }
+
+    /* comparison */
+    friend bool operator==(const tile2d_iterator &lhs, const tile2d_iterator &rhs) {
+        return lhs.t == rhs.t;
+    }
+    friend bool operator!=(const tile2d_iterator &lhs, const tile2d_iterator &rhs) {
+        return !(lhs == rhs);
+    }
+
+    /* random access comparisons */
+    friend bool operator<(const tile2d_iterator &lhs, const tile2d_iterator &rhs) {
+        return lhs.t < rhs.t;
+    }
+    friend bool operator>(const tile2d_iterator &lhs, const tile2d_iterator &rhs) {
+        return lhs.t > rhs.t;
+    }
+    friend bool operator<=(const tile2d_iterator &lhs, const tile2d_iterator &rhs) {
+        return lhs.t <= rhs.t;
+    }
+    friend bool operator>=(const tile2d_iterator &lhs, const tile2d_iterator &rhs) {
+        return lhs.t >= rhs.t;
+    }
+
+private:
+    It first;
+    difference_type rows = 0, cols = 0;
+    difference_type tile = 1, tiles_per_row = 0;
+    difference_type t = 0;
+};
+
+/* tile2d view: splits a row-major rows x cols range into tile x tile blocks */
+template <typename It>
+class tile2d {
+public:
+    tile2d() = default;
+
+    template <typename Range, std::enable_if_t<detail::is_other_range<Range, tile2d>, int> = 0>
+    explicit tile2d(Range &&range, std::ptrdiff_t rows, std::ptrdiff_t cols, std::ptrdiff_t tile)
+      : begin_(driftmeta::adl_begin(range),
+               detail::checked_extent(rows, 0, "tile2d rows must not be negative"),
+               detail::checked_extent(cols, 0, "tile2d cols must not be negative"),
+               detail::checked_extent(tile, 1, "tile2d tile size must be positive")),
+        end_(driftmeta::adl_begin(range), rows, cols, tile,
+             ((rows + tile - 1) / tile) * ((cols + tile - 1) / tile)) {}
+
+    tile2d_iterator<It> begin() const { return begin_; }
+    tile2d_iterator<It> end() const { return end_; }
+    iter_difference_t<tile2d_iterator<It>> size() const { return end_ - begin_; }
+
+private:
+    tile2d_iterator<It> begin_;
+    tile2d_iterator<It> end_;
+};
+
+template <typename Range>
+tile2d(Range &&range, std::ptrdiff_t rows, std::ptrdiff_t cols, std::ptrdiff_t tile)
+    ->tile2d<decltype(driftmeta::adl_begin(range))>;
+
 } // namespace drift
\ No newline at end of file
@@ -28,7 +28,17 @@
  * without including the above copyright and permission notices.
  */
 
+#pragma once
+
+#include <array>
+#include <cstddef>
 #include <functional>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
 
 namespace drift {
 
@@ -40,22 +50,474 @@ struct overloaded : Ts... {
 template <typename... Ts>
 overloaded(Ts...) -> overloaded<Ts...>;
 
+/* a dysfunction<R, Args...> keeps one copy of an overload set, in place when it fits in a few
+ * words and on the heap otherwise, and a pointer to a table of functions that know its type:
+ * one call per signature R(Arg), plus copy, move and destroy. calling it is a single indirect
+ * call. sets that could throw while being moved are always kept on the heap, so that moving a
+ * dysfunction never throws and never allocates; it just leaves the source empty.
+ *
+ * an inplace_dysfunction<N, R, Args...> is the same with room for N bytes, and no heap: sets
+ * that don't fit, or could throw while being moved, don't compile.
+ */
+namespace detail {
+template <std::size_t Size, std::size_t Align, bool HeapAllowed>
+union dysfunction_storage {
+    static constexpr std::size_t size = Size;
+    static constexpr bool heap_allowed = HeapAllowed;
+
+    void *heap;
+    alignas(Align) unsigned char local[Size];
+};
+
+using default_dysfunction_storage = dysfunction_storage<4 * sizeof(void *), alignof(void *), true>;
+
+template <typename F, typename Storage>
+constexpr bool is_stored_locally = sizeof(F) <= Storage::size and
+                                   alignof(F) <= alignof(Storage) and
+                                   std::is_nothrow_move_constructible_v<F>;
+
+template <typename F, typename Storage>
+F &stored(Storage &s) {
+    if constexpr (is_stored_locally<F, Storage>)
+        return *std::launder(reinterpret_cast<F *>(s.local));
+    else
+        return *static_cast<F *>(s.heap);
+}
+
+template <typename F, typename Storage>
+const F &stored(const Storage &s) {
+    return stored<F>(const_cast<Storage &>(s));
+}
+
+template <typename F, typename Storage, typename... Ts>
+void construct_stored(Storage &s, Ts &&... ts) {
+    if constexpr (is_stored_locally<F, Storage>) {
+        ::new (static_cast<void *>(s.local)) F{std::forward<Ts>(ts)...};
+    } else {
+        static_assert(Storage::heap_allowed,
+                      "this overload set is too large for an inplace_dysfunction, or its move "
+                      "constructor isn't noexcept");
+        s.heap = new F{std::forward<Ts>(ts)...};
+    }
+}
+
+template <typename Storage, typename R, typename... Args>
+struct dysfunction_vtable {
+    std::tuple<R (*)(Storage &, Args &&)...> call;
+    /* calls signature i once for every argument pointed to, discarding the results */
+    std::array<void (*)(Storage &, void *const *args, std::size_t n), sizeof...(Args)> call_each;
+    void (*copy)(const Storage &from, Storage &to);
+    /* leaves 'from' with nothing to destroy */
+    void (*move)(Storage &from, Storage &to) noexcept;
+    void (*destroy)(Storage &s) noexcept;
+};
+
+template <typename F, typename Storage, typename R, typename Arg>
+R call_stored(Storage &s, Arg &&arg) {
+    if constexpr (std::is_void_v<R>)
+        stored<F>(s)(std::forward<Arg>(arg));
+    else
+        return stored<F>(s)(std::forward<Arg>(arg));
+}
+
+template <typename F, typename Storage, typename Arg>
+void call_each_stored(Storage &s, void *const *args, std::size_t n) {
+    auto &f = stored<F>(s);
+    for (std::size_t i = 0; i != n; ++i)
+        f(static_cast<Arg>(*static_cast<std::remove_reference_t<Arg> *>(args[i])));
+}
+
+template <typename F, typename Storage>
+void copy_stored(const Storage &from, Storage &to) {
+    construct_stored<F>(to, stored<F>(from));
+}
+
+template <typename F, typename Storage>
+void move_stored(Storage &from, Storage &to) noexcept {
+    if constexpr (is_stored_locally<F, Storage>) {
+        construct_stored<F>(to, std::move(stored<F>(from)));
+        stored<F>(from).~F();
+    } else {
+        to.heap = from.heap;
+    }
+}
+
+template <typename F, typename Storage>
+void destroy_stored(Storage &s) noexcept {
+    if constexpr (is_stored_locally<F, Storage>)
+        stored<F>(s).~F();
+    else
+        delete &stored<F>(s);
+}
+
+template <typename F, typename Storage, typename R, typename... Args>
+inline constexpr dysfunction_vtable<Storage, R, Args...> vtable_for = {
+    {&call_stored<F, Storage, R, Args>...}, {{&call_each_stored<F, Storage, Args>...}},
+    &copy_stored<F, Storage>, &move_stored<F, Storage>, &destroy_stored<F, Storage>};
+
+/* what empty and moved-from dysfunctions point to */
+template <typename Storage, typename R, typename Arg>
+R call_empty(Storage &, Arg &&) {
+    throw std::bad_function_call();
+}
+
+template <typename Storage, typename Arg>
+void call_each_empty(Storage &, void *const *, std::size_t) {
+    throw std::bad_function_call();
+}
+
+template <typename Storage>
+void copy_empty(const Storage &, Storage &) {}
+
+template <typename Storage>
+void move_empty(Storage &, Storage &) noexcept {}
+
+template <typename Storage>
+void destroy_empty(Storage &) noexcept {}
+
+template <typename Storage, typename R, typename... Args>
+inline constexpr dysfunction_vtable<Storage, R, Args...> empty_vtable = {
+    {&call_empty<Storage, R, Args>...}, {{&call_each_empty<Storage, Args>...}},
+    &copy_empty<Storage>, &move_empty<Storage>, &destroy_empty<Storage>};
+
+/* one operator() per signature, each calling through its own slot of the table. the non-const
+ * one lets a dysfunction whose calls differ by constness pick the right one
+ */
+template <typename Dysfunction, std::size_t I, typename R, typename Arg>
+struct dysfunction_call {
+    constexpr R operator()(Arg arg) const {
+        return static_cast<const Dysfunction &>(*this).template call<I>(std::forward<Arg>(arg));
+    }
+    constexpr R operator()(Arg arg) {
+        return static_cast<Dysfunction &>(*this).template call<I>(std::forward<Arg>(arg));
+    }
+};
+
+template <typename Dysfunction, typename R, typename Indices, typename... Args>
+struct dysfunction_calls;
+
+template <typename Dysfunction, typename R, std::size_t... I, typename... Args>
+struct dysfunction_calls<Dysfunction, R, std::index_sequence<I...>, Args...>
+  : dysfunction_call<Dysfunction, I, R, Args>... {
+    using dysfunction_call<Dysfunction, I, R, Args>::operator()...;
+};
+
+/* the signature whose argument decays to T, or the number of signatures if there is none */
+template <typename T, typename... Args>
+constexpr std::size_t signature_of() {
+    constexpr bool matches[] = {std::is_same_v<std::decay_t<Args>, T>..., true};
+    std::size_t i = 0;
+    while (!matches[i])
+        ++i;
+    return i;
+}
+
+constexpr std::size_t dispatch_block = 256;
+
+/* reads a range of std::variants a block at a time, sorts each block by alternative, counting
+ * sort style, and calls group(J, I, messages, n) with the n > 0 messages holding alternative J,
+ * in order, and I the signature that takes it
+ */
+template <typename... Args, typename It, typename Group, std::size_t... J>
+void dispatch_grouped(It first, It last, Group &group, std::index_sequence<J...>) {
+    using variant = std::remove_reference_t<decltype(*first)>;
+    constexpr std::size_t slots[] = {
+        signature_of<std::variant_alternative_t<J, std::remove_cv_t<variant>>, Args...>()...};
+    static_assert(((slots[J] < sizeof...(Args)) and ...),
+                  "every alternative needs a signature that takes it");
+    static_assert(
+        (std::is_convertible_v<decltype(std::get<J>(std::declval<variant &>())),
+                               std::tuple_element_t<slots[J], std::tuple<Args...>>> and
+         ...),
+        "messages are passed as lvalues, which some signature can't take");
+
+    std::array<variant *, dispatch_block> items, grouped;
+    std::array<std::size_t, dispatch_block> tags;
+    while (first != last) {
+        std::array<std::size_t, sizeof...(J) + 1> offsets{};
+        std::size_t n = 0;
+        for (; n != dispatch_block and first != last; ++n, ++first) {
+            auto &message = *first;
+            if (message.valueless_by_exception())
+                throw std::bad_variant_access();
+            items[n] = std::addressof(message);
+            tags[n] = message.index();
+            ++offsets[tags[n] + 1];
+        }
+        for (std::size_t j = 1; j != offsets.size(); ++j)
+            offsets[j] += offsets[j - 1];
+        auto next = offsets;
+        for (std::size_t i = 0; i != n; ++i)
+            grouped[next[tags[i]]++] = items[i];
+        ((offsets[J + 1] != offsets[J]
+              ? group(std::integral_constant<std::size_t, J>(),
+                      std::integral_constant<std::size_t, slots[J]>(), grouped.data() + offsets[J],
+                      offsets[J + 1] - offsets[J])
+              : void()),
+         ...);
+    }
+}
+
+template <typename... Args, typename Range, typename Group>
+void dispatch_grouped(Range &&messages, Group &&group) {
+    using std::begin;
+    using std::end;
+
+    auto first = begin(messages);
+    using variant = std::remove_cv_t<std::remove_reference_t<decltype(*first)>>;
+    dispatch_grouped<Args...>(first, end(messages), group,
+                              std::make_index_sequence<std::variant_size_v<variant>>());
+}
+
+template <typename Storage, typename R, typename... Args>
+class basic_dysfunction
+  : public dysfunction_calls<basic_dysfunction<Storage, R, Args...>, R,
+                             std::index_sequence_for<Args...>, Args...> {
+    template <typename T>
+    static constexpr bool is_dysfunction =
+        std::is_same_v<std::remove_cv_t<std::remove_reference_t<T>>, basic_dysfunction>;
+
+    static constexpr auto empty = &empty_vtable<Storage, R, Args...>;
+
+public:
+    /* an empty dysfunction throws std::bad_function_call when called */
+    basic_dysfunction() noexcept = default;
+
+    template <typename... Ts,
+              std::enable_if_t<(sizeof...(Ts) > 1 or
+                                (sizeof...(Ts) == 1 and !(is_dysfunction<Ts> or ...))),
+                               int> = 0>
+    basic_dysfunction(Ts &&... ts)
+      : vtable(&vtable_for<overloaded<std::decay_t<Ts>...>, Storage, R, Args...>) {
+        construct_stored<overloaded<std::decay_t<Ts>...>>(storage, std::forward<Ts>(ts)...);
+    }
+
+    basic_dysfunction(const basic_dysfunction &other) : vtable(other.vtable) {
+        vtable->copy(other.storage, storage);
+    }
+
+    basic_dysfunction(basic_dysfunction &&other) noexcept : vtable(other.vtable) {
+        vtable->move(other.storage, storage);
+        other.vtable = empty;
+    }
+
+    basic_dysfunction &operator=(const basic_dysfunction &other) {
+        if (this != &other)
+            *this = basic_dysfunction(other);
+        return *this;
+    }
+
+    basic_dysfunction &operator=(basic_dysfunction &&other) noexcept {
+        if (this != &other) {
+            vtable->destroy(storage);
+            other.vtable->move(other.storage, storage);
+            vtable = std::exchange(other.vtable, empty);
+        }
+        return *this;
+    }
+
+    ~basic_dysfunction() { vtable->destroy(storage); }
+
+    void swap(basic_dysfunction &other) noexcept {
+        auto tmp = std::move(other);
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend void swap(basic_dysfunction &a, basic_dysfunction &b) noexcept { a.swap(b); }
+
+    explicit operator bool() const noexcept { return vtable != empty; }
+
+    /* calls the overload set on every element of a range of std::variants, whose alternatives
+     * are argument types of the signatures. rather than making one unpredictable indirect call
+     * per message, blocks of messages are sorted by alternative, counting sort style, and each
+     * alternative's messages go through one call that loops over them with the overload
+     * inlined. messages of one alternative are handled in order, but an alternative's messages
+     * are all handled before the next one's, and results are discarded.
+     */
+    template <typename Range>
+    void dispatch(Range &&messages) const {
+        dispatch_grouped<Args...>(messages, [this](auto j, auto i, auto messages, std::size_t n) {
+            std::array<void *, dispatch_block> args;
+            for (std::size_t m = 0; m != n; ++m)
+                args[m] =
+                    const_cast<void *>(static_cast<const void *>(std::get_if<j>(messages[m])));
+            vtable->call_each[i](storage, args.data(), n);
+        });
+    }
+
+private:
+    template <typename, std::size_t, typename, typename>
+    friend struct dysfunction_call;
+
+    template <std::size_t I, typename Arg>
+    R call(Arg &&arg) const {
+        return std::get<I>(vtable->call)(storage, std::forward<Arg>(arg));
+    }
+
+    const dysfunction_vtable<Storage, R, Args...> *vtable = empty;
+    /* calls are const, as with std::function, but the overload set they reach isn't */
+    mutable Storage storage;
+};
+} // namespace detail
+
+template <typename R, typename... Args>
+using dysfunction = detail::basic_dysfunction<detail::default_dysfunction_storage, R, Args...>;
+
+template <std::size_t N, typename R, typename... Args>
+using inplace_dysfunction =
+    detail::basic_dysfunction<detail::dysfunction_storage<N, alignof(std::max_align_t), false>, R,
+                              Args...>;
+
+/* dysfunction_ref is the non-owning counterpart of dysfunction, for callbacks that don't
+ * outlive the call they're passed to: it is two pointers, one to the overload set and one to a
+ * table of calls, copying it is trivial and calling it is one indirect call. it references
+ * whatever it was made from, which has to be kept alive.
+ */
+namespace detail {
+template <typename R, typename... Args>
+struct dysfunction_ref_vtable {
+    std::tuple<R (*)(void *, Args &&)...> call;
+};
+
+template <typename F, typename R, typename Arg>
+R call_referenced(void *object, Arg &&arg) {
+    if constexpr (std::is_void_v<R>)
+        (*static_cast<F *>(object))(std::forward<Arg>(arg));
+    else
+        return (*static_cast<F *>(object))(std::forward<Arg>(arg));
+}
+
+template <typename F, typename R, typename... Args>
+inline constexpr dysfunction_ref_vtable<R, Args...> ref_vtable_for = {
+    {&call_referenced<F, R, Args>...}};
+} // namespace detail
+
 template <typename R, typename... Args>
-struct dysfunction : private std::function<R(Args)>... {
-    using std::function<R(Args)>::operator()...;
+class dysfunction_ref
+  : public detail::dysfunction_calls<dysfunction_ref<R, Args...>, R,
+                                     std::index_sequence_for<Args...>, Args...> {
+    template <typename T>
+    static constexpr bool is_dysfunction_ref =
+        std::is_same_v<std::remove_cv_t<std::remove_reference_t<T>>, dysfunction_ref>;
+
+public:
+    template <typename F, std::enable_if_t<!is_dysfunction_ref<F>, int> = 0>
+    dysfunction_ref(F &&f) noexcept
+      : vtable(&detail::ref_vtable_for<std::remove_reference_t<F>, R, Args...>),
+        object(const_cast<void *>(static_cast<const void *>(std::addressof(f)))) {}
+
+private:
+    template <typename, std::size_t, typename, typename>
+    friend struct detail::dysfunction_call;
+
+    template <std::size_t I, typename Arg>
+    R call(Arg &&arg) const {
+        return std::get<I>(vtable->call)(object, std::forward<Arg>(arg));
+    }
+
+    const detail::dysfunction_ref_vtable<R, Args...> *vtable;
+    void *object;
+};
 
-    template <typename... Ts>
-    dysfunction(Ts &&...ts) : dysfunction(overloaded{std::forward<Ts>(ts)...}) {}
+/* static_dysfunction<F, R, Args...> has the interface of dysfunction<R, Args...> without the
+ * type erasure: it keeps an F, usually an overloaded, and calls it directly, so the compiler
+ * can inline through every call. besides the operator()s, which std::visit can use, visit(v)
+ * calls the signature for the alternative v holds through a chain of index comparisons that
+ * compilers turn into a switch. a const static_dysfunction calls a const F, so calls and visits
+ * are usable in constant expressions whenever F's are; a non-const one can hold mutable
+ * lambdas. make_dispatch_table<R, Args...>(ts...) makes one from callables.
+ */
+template <typename F, typename R, typename... Args>
+class static_dysfunction
+  : public detail::dysfunction_calls<static_dysfunction<F, R, Args...>, R,
+                                     std::index_sequence_for<Args...>, Args...> {
+public:
+    constexpr explicit static_dysfunction(F f) : f(std::move(f)) {}
+
+    template <typename Variant>
+    constexpr R visit(Variant &&v) const {
+        return visit_in(*this, std::forward<Variant>(v));
+    }
+    template <typename Variant>
+    constexpr R visit(Variant &&v) {
+        return visit_in(*this, std::forward<Variant>(v));
+    }
+
+    /* groups messages like dysfunction::dispatch does, with the calls inlined into the loops */
+    template <typename Range>
+    void dispatch(Range &&messages) const {
+        dispatch_in(*this, messages);
+    }
+    template <typename Range>
+    void dispatch(Range &&messages) {
+        dispatch_in(*this, messages);
+    }
 
 private:
-    template <typename... Ts>
-    dysfunction(overloaded<Ts...> &&ov)
-      : te_ov([=]() mutable -> void * { return &ov; }),
-        std::function<R(Args)>([this](Args &&args) {
-            return (*static_cast<overloaded<Ts...> *>(te_ov()))(std::forward<Args>(args));
-        })... {}
+    template <typename, std::size_t, typename, typename>
+    friend struct detail::dysfunction_call;
+
+    template <std::size_t I, typename Arg>
+    constexpr R call(Arg &&arg) const {
+        return invoke(f, std::forward<Arg>(arg));
+    }
+    template <std::size_t I, typename Arg>
+    constexpr R call(Arg &&arg) {
+        return invoke(f, std::forward<Arg>(arg));
+    }
+
+    template <typename G, typename Arg>
+    static constexpr R invoke(G &g, Arg &&arg) {
+        if constexpr (std::is_void_v<R>)
+            g(std::forward<Arg>(arg));
+        else
+            return g(std::forward<Arg>(arg));
+    }
 
-    std::function<void *(void)> te_ov;
+    /* self is *this, const or not */
+    template <typename Self, typename Variant>
+    static constexpr R visit_in(Self &self, Variant &&v) {
+        if (v.valueless_by_exception())
+            throw std::bad_variant_access();
+        return visit_from<0>(self, std::forward<Variant>(v));
+    }
+
+    template <typename Self, typename Range>
+    static void dispatch_in(Self &self, Range &messages) {
+        detail::dispatch_grouped<Args...>(
+            messages, [&self](auto j, auto i, auto messages, std::size_t n) {
+                using arg = std::tuple_element_t<i, std::tuple<Args...>>;
+                for (std::size_t m = 0; m != n; ++m)
+                    self.template call<i>(static_cast<arg>(*std::get_if<j>(messages[m])));
+            });
+    }
+
+    /* calls the signature taking alternative J if v holds it, or tries J + 1 */
+    template <std::size_t J, typename Self, typename Variant>
+    static constexpr R visit_from(Self &self, Variant &&v) {
+        using variant = std::remove_cv_t<std::remove_reference_t<Variant>>;
+        constexpr auto I = detail::signature_of<std::variant_alternative_t<J, variant>, Args...>();
+        static_assert(I < sizeof...(Args), "every alternative needs a signature that takes it");
+        using arg = std::tuple_element_t<I, std::tuple<Args...>>;
+
+        if constexpr (J + 1 == std::variant_size_v<variant>) {
+            return self.template call<I>(static_cast<arg>(std::get<J>(std::forward<Variant>(v))));
+        } else {
+            if (v.index() == J)
+                return self.template call<I>(
+                    static_cast<arg>(std::get<J>(std::forward<Variant>(v))));
+            return visit_from<J + 1>(self, std::forward<Variant>(v));
+        }
+    }
+
+    F f;
 };
 
+template <typename R, typename... Args, typename... Ts>
+constexpr auto make_dispatch_table(Ts &&... ts) {
+    return static_dysfunction<overloaded<std::decay_t<Ts>...>, R, Args...>(
+        overloaded<std::decay_t<Ts>...>{std::forward<Ts>(ts)...});
+}
+
 } // namespace drift
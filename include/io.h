@@ -0,0 +1,491 @@
+/* file-backed ranges.
+ *
+ * Copyright (c) 2026 - present, Leandro Medina de Oliveira
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR \
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * --- Optional exception to the license ---
+ *
+ * As an exception, if, as a result of your compiling your source code, portions
+ * of this Software are embedded into a machine-executable object form of such
+ * source code, you may redistribute such embedded portions in such object form
+ * without including the above copyright and permission notices.
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace drift {
+
+enum class map_mode {
+    read_only,     /* writing through the mapping faults */
+    read_write,    /* writes go to the file */
+    copy_on_write, /* writes stay private to the mapping */
+};
+
+/* access pattern hints, passed on to madvise() where there is one */
+enum class map_access {
+    normal,
+    sequential, /* aggressive read-ahead, pages dropped soon after use */
+    random,     /* no read-ahead */
+    willneed,   /* start reading the whole file in now */
+};
+
+namespace detail {
+/* a memory mapping of a whole file: the platform bits of mapped_array */
+class file_mapping {
+public:
+    file_mapping() = default;
+
+    /* maps 'path', first resizing it to 'size' bytes if that isn't -1 (read_write only) */
+    file_mapping(const std::string &path, map_mode mode, std::ptrdiff_t size = -1,
+                 bool huge_pages = false) {
+#ifdef _WIN32
+        auto writable = mode != map_mode::read_only;
+        auto file = ::CreateFileA(path.c_str(), GENERIC_READ | (writable ? GENERIC_WRITE : 0),
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                  size >= 0 ? OPEN_ALWAYS : OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw_last_error("drift::mapped_array: cannot open " + path);
+
+        LARGE_INTEGER file_size;
+        if (size >= 0) {
+            file_size.QuadPart = size;
+            if (!::SetFilePointerEx(file, file_size, nullptr, FILE_BEGIN) or
+                !::SetEndOfFile(file)) {
+                ::CloseHandle(file);
+                throw_last_error("drift::mapped_array: cannot resize " + path);
+            }
+        } else if (!::GetFileSizeEx(file, &file_size)) {
+            ::CloseHandle(file);
+            throw_last_error("drift::mapped_array: cannot stat " + path);
+        }
+        size_ = std::size_t(file_size.QuadPart);
+
+        if (size_ != 0) {
+            auto protect = mode == map_mode::read_only    ? PAGE_READONLY
+                           : mode == map_mode::read_write ? PAGE_READWRITE
+                                                          : PAGE_WRITECOPY;
+            auto mapping = ::CreateFileMappingA(file, nullptr, protect, 0, 0, nullptr);
+            if (!mapping) {
+                ::CloseHandle(file);
+                throw_last_error("drift::mapped_array: cannot map " + path);
+            }
+            auto access = mode == map_mode::read_only    ? FILE_MAP_READ
+                          : mode == map_mode::read_write ? FILE_MAP_WRITE
+                                                         : FILE_MAP_COPY;
+            data_ = ::MapViewOfFile(mapping, access, 0, 0, 0);
+            ::CloseHandle(mapping);
+            if (!data_) {
+                ::CloseHandle(file);
+                throw_last_error("drift::mapped_array: cannot map " + path);
+            }
+        }
+        ::CloseHandle(file);
+        (void)huge_pages; /* large pages can't back file mappings on windows */
+#else
+        auto flags = mode == map_mode::read_write ? O_RDWR : O_RDONLY;
+        auto fd = ::open(path.c_str(), size >= 0 ? flags | O_CREAT : flags, 0644);
+        if (fd < 0)
+            throw_errno("drift::mapped_array: cannot open " + path);
+
+        if (size >= 0) {
+            if (::ftruncate(fd, off_t(size)) != 0) {
+                ::close(fd);
+                throw_errno("drift::mapped_array: cannot resize " + path);
+            }
+            size_ = std::size_t(size);
+        } else {
+            struct stat st;
+            if (::fstat(fd, &st) != 0) {
+                ::close(fd);
+                throw_errno("drift::mapped_array: cannot stat " + path);
+            }
+            size_ = std::size_t(st.st_size);
+        }
+
+        if (size_ != 0) {
+            auto prot = mode == map_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+            auto share = mode == map_mode::copy_on_write ? MAP_PRIVATE : MAP_SHARED;
+            auto p = ::mmap(nullptr, size_, prot, share, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw_errno("drift::mapped_array: cannot map " + path);
+            }
+            data_ = p;
+#ifdef MADV_HUGEPAGE
+            if (huge_pages)
+                ::madvise(data_, size_, MADV_HUGEPAGE);
+#else
+            (void)huge_pages;
+#endif
+        }
+        ::close(fd);
+#endif
+    }
+
+    file_mapping(const file_mapping &) = delete;
+    file_mapping &operator=(const file_mapping &) = delete;
+
+    file_mapping(file_mapping &&rhs) noexcept
+      : data_(std::exchange(rhs.data_, nullptr)), size_(std::exchange(rhs.size_, 0)) {}
+    file_mapping &operator=(file_mapping &&rhs) noexcept {
+        file_mapping(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    ~file_mapping() {
+        if (!data_)
+            return;
+#ifdef _WIN32
+        ::UnmapViewOfFile(data_);
+#else
+        ::munmap(data_, size_);
+#endif
+    }
+
+    void swap(file_mapping &other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+    }
+
+    void *data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+
+    /* hints are best-effort: failures are ignored */
+    void advise(map_access access, std::size_t offset, std::size_t length) const noexcept {
+        if (!data_ or length == 0)
+            return;
+#ifdef _WIN32
+        if (access == map_access::willneed) {
+            WIN32_MEMORY_RANGE_ENTRY range{static_cast<char *>(data_) + offset, length};
+            ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+        }
+#else
+        /* madvise wants a page-aligned start */
+        auto page = std::size_t(::sysconf(_SC_PAGESIZE));
+        auto first = offset / page * page;
+        auto advice = access == map_access::sequential ? MADV_SEQUENTIAL
+                      : access == map_access::random   ? MADV_RANDOM
+                      : access == map_access::willneed ? MADV_WILLNEED
+                                                       : MADV_NORMAL;
+        ::madvise(static_cast<char *>(data_) + first, offset + length - first, advice);
+#endif
+    }
+
+    /* flushes written pages to the file */
+    void sync() const {
+        if (!data_)
+            return;
+#ifdef _WIN32
+        if (!::FlushViewOfFile(data_, 0))
+            throw_last_error("drift::mapped_array: cannot sync");
+#else
+        if (::msync(data_, size_, MS_SYNC) != 0)
+            throw_errno("drift::mapped_array: cannot sync");
+#endif
+    }
+
+private:
+    void *data_ = nullptr;
+    std::size_t size_ = 0;
+
+#ifdef _WIN32
+    [[noreturn]] static void throw_last_error(const std::string &what) {
+        throw std::system_error(int(::GetLastError()), std::system_category(), what);
+    }
+#else
+    [[noreturn]] static void throw_errno(const std::string &what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+#endif
+};
+} // namespace detail
+
+/* mapped array: a file of T's, memory-mapped and viewed as a contiguous random access range.
+ *
+ * nothing is read up front; pages are faulted in on first touch, so opening a file costs the
+ * same whatever its size. mapped arrays own their mapping, and like any container have to
+ * outlive the views (zip, indexed...) built on them. a trailing partial element is ignored.
+ */
+template <typename T>
+class mapped_array {
+    static_assert(std::is_trivially_copyable_v<T>, "mapped_array holds raw bytes of T's");
+
+public:
+    using value_type = std::remove_cv_t<T>;
+    using pointer = T *;
+    using reference = T &;
+    using iterator = T *;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    mapped_array() = default;
+
+    /* maps an existing file, read only for arrays of const T and copy on write otherwise, so
+     * writes never reach the file unless asked for with read_write
+     */
+    explicit mapped_array(const std::string &path,
+                          map_mode mode = std::is_const_v<T> ? map_mode::read_only
+                                                             : map_mode::copy_on_write,
+                          map_access access = map_access::normal, bool huge_pages = false)
+      : map_(path, check(mode), -1, huge_pages) {
+        advise(access);
+    }
+
+    /* creates or resizes a file to hold n T's, and maps it for writing */
+    explicit mapped_array(const std::string &path, size_type n,
+                          map_access access = map_access::normal, bool huge_pages = false)
+      : map_(path, check(map_mode::read_write), std::ptrdiff_t(n * sizeof(T)), huge_pages) {
+        advise(access);
+    }
+
+    T *data() const noexcept { return static_cast<T *>(map_.data()); }
+    size_type size() const noexcept { return map_.size() / sizeof(T); }
+    bool empty() const noexcept { return size() == 0; }
+
+    T *begin() const noexcept { return data(); }
+    T *end() const noexcept { return data() + size(); }
+
+    T &operator[](size_type i) const noexcept { return data()[i]; }
+
+    /* hints the kernel about how the whole array, or [first, first + n), will be read */
+    void advise(map_access access) const noexcept { map_.advise(access, 0, map_.size()); }
+    void advise(map_access access, size_type first, size_type n) const noexcept {
+        map_.advise(access, first * sizeof(T), n * sizeof(T));
+    }
+
+    /* flushes writes to the file; unmapping a read_write array does so eventually anyway */
+    void sync() const { map_.sync(); }
+
+private:
+    detail::file_mapping map_;
+
+    static map_mode check(map_mode mode) {
+        if (std::is_const_v<T> and mode != map_mode::read_only)
+            throw std::invalid_argument("drift::mapped_array: arrays of const T are read only");
+        return mode;
+    }
+};
+
+/* records: an input range over the delimiter-separated records of a file, as string_views.
+ *
+ * the file is read in large blocks into two buffers that are reused throughout: while the
+ * consumer works through one, a background task fills the other. records are views into
+ * those buffers, valid until the next increment; only a record straddling two blocks gets
+ * copied, into a buffer that is also reused. the background task runs on its own thread,
+ * or on a task pool (anything with an async(f) member returning a std::future<void>).
+ * like a generator, a records range has to outlive the iterators and views taken from it.
+ */
+class records {
+    struct state {
+        std::FILE *file = nullptr;
+        std::size_t block_size;
+        char delimiter;
+        std::function<std::future<void>(std::function<void()>)> launch;
+
+        std::vector<char> buffers[2];
+        std::size_t lengths[2] = {};
+        unsigned front = 1;
+        std::future<void> pending;
+        bool eof = false;
+
+        const char *pos = nullptr, *end = nullptr;
+        std::string carry;
+        bool carry_used = false;
+        std::string_view current;
+        bool live = false;
+
+        ~state() {
+            if (pending.valid())
+                pending.wait();
+            if (file)
+                std::fclose(file);
+        }
+
+        void read_ahead() {
+            auto back = 1 - front;
+            pending = launch([this, back] {
+                lengths[back] = std::fread(buffers[back].data(), 1, block_size, file);
+                if (lengths[back] < block_size and std::ferror(file))
+                    throw std::system_error(errno, std::generic_category(),
+                                            "drift::records: read error");
+            });
+        }
+
+        /* makes the block being read ahead the current one, and starts on the next */
+        bool swap_buffers() {
+            if (eof)
+                return false;
+            pending.get();
+            front = 1 - front;
+            if (lengths[front] == 0) {
+                eof = true;
+                return false;
+            }
+            pos = buffers[front].data();
+            end = pos + lengths[front];
+            read_ahead();
+            return true;
+        }
+
+        bool next() {
+            if (carry_used) {
+                carry.clear();
+                carry_used = false;
+            }
+            while (true) {
+                auto found = pos == end ? nullptr
+                                        : static_cast<const char *>(
+                                              std::memchr(pos, delimiter, std::size_t(end - pos)));
+                if (found) {
+                    if (carry.empty()) {
+                        current = std::string_view(pos, found - pos);
+                    } else {
+                        carry.append(pos, found);
+                        current = carry;
+                        carry_used = true;
+                    }
+                    pos = found + 1;
+                    return true;
+                }
+                carry.append(pos, end);
+                pos = end;
+                if (!swap_buffers()) {
+                    /* a last record without a trailing delimiter */
+                    if (carry.empty())
+                        return false;
+                    current = carry;
+                    carry_used = true;
+                    return true;
+                }
+            }
+        }
+    };
+
+public:
+    static constexpr std::size_t default_block_size = std::size_t(4) << 20;
+
+    class iterator {
+    public:
+        /* usual iterator typedefs */
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::string_view;
+        using pointer = const std::string_view *;
+        using reference = std::string_view;
+        using iterator_category = std::input_iterator_tag;
+
+        iterator() = default;
+        explicit iterator(state *s) : s(s) {}
+
+        /* dereference */
+        reference operator*() const { return s->current; }
+        pointer operator->() const { return &s->current; }
+
+        /* increment */
+        iterator &operator++() {
+            if (!(s->live = s->next()))
+                s = nullptr;
+            return *this;
+        }
+
+        void operator++(int) { ++(*this); }
+
+        /* comparison */
+        friend bool operator==(const iterator &lhs, const iterator &rhs) { return lhs.s == rhs.s; }
+        friend bool operator!=(const iterator &lhs, const iterator &rhs) { return !(lhs == rhs); }
+
+    private:
+        state *s = nullptr;
+    };
+
+    explicit records(const std::string &path, char delimiter = '\n',
+                     std::size_t block_size = default_block_size)
+      : records(path, delimiter, block_size, [](std::function<void()> f) {
+            return std::async(std::launch::async, std::move(f));
+        }) {}
+
+    template <typename Pool,
+              std::enable_if_t<!std::is_convertible_v<Pool &, const std::string &>, int> = 0>
+    explicit records(Pool &pool, const std::string &path, char delimiter = '\n',
+                     std::size_t block_size = default_block_size)
+      : records(path, delimiter, block_size,
+                [&pool](std::function<void()> f) { return pool.async(std::move(f)); }) {}
+
+    iterator begin() {
+        if (!started_) {
+            started_ = true;
+            s_->live = s_->next();
+        }
+        return s_->live ? iterator(s_.get()) : iterator();
+    }
+    iterator end() { return iterator(); }
+
+private:
+    std::unique_ptr<state> s_;
+    bool started_ = false;
+
+    records(const std::string &path, char delimiter, std::size_t block_size,
+            std::function<std::future<void>(std::function<void()>)> launch)
+      : s_(std::make_unique<state>()) {
+        if (block_size == 0)
+            throw std::invalid_argument("drift::records: block size must be positive");
+
+        s_->file = std::fopen(path.c_str(), "rb");
+        if (!s_->file)
+            throw std::system_error(errno, std::generic_category(),
+                                    "drift::records: cannot open " + path);
+        s_->block_size = block_size;
+        s_->delimiter = delimiter;
+        s_->launch = std::move(launch);
+        s_->buffers[0].resize(block_size);
+        s_->buffers[1].resize(block_size);
+        s_->read_ahead();
+    }
+};
+
+} // namespace drift
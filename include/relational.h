@@ -0,0 +1,801 @@
+/* relational algorithms over tables, which are zips of columns.
+ *
+ * Copyright (c) 2026 - present, Leandro Medina de Oliveira
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR \
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * --- Optional exception to the license ---
+ *
+ * As an exception, if, as a result of your compiling your source code, portions
+ * of this Software are embedded into a machine-executable object form of such
+ * source code, you may redistribute such embedded portions in such object form
+ * without including the above copyright and permission notices.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithm.h"
+#include "drift.h"
+
+namespace drift {
+
+/* aggregators for group_by. each one folds a column's values in a group into a state: start(x)
+ * makes the state from the group's first value, add(state, x) adds the next one,
+ * merge(state, other) adds the state of values that came after and result(state) is the
+ * group's result.
+ */
+namespace aggregate {
+struct count_t {
+    template <typename T>
+    std::size_t start(const T &) const {
+        return 1;
+    }
+    template <typename T>
+    void add(std::size_t &n, const T &) const {
+        ++n;
+    }
+    void merge(std::size_t &n, std::size_t other) const { n += other; }
+    std::size_t result(std::size_t n) const { return n; }
+};
+
+/* arithmetic values are summed like summarize does, in int64, uint64 or double */
+struct sum_t {
+    template <typename T>
+    auto start(const T &x) const {
+        if constexpr (std::is_arithmetic_v<T>)
+            return detail::summary_sum_t<T>(x);
+        else
+            return T(x);
+    }
+    template <typename S, typename T>
+    void add(S &s, const T &x) const {
+        s += x;
+    }
+    template <typename S>
+    void merge(S &s, const S &other) const {
+        s += other;
+    }
+    template <typename S>
+    S result(const S &s) const {
+        return s;
+    }
+};
+
+struct min_t {
+    template <typename T>
+    T start(const T &x) const {
+        return x;
+    }
+    template <typename T>
+    void add(T &s, const T &x) const {
+        if (x < s)
+            s = x;
+    }
+    template <typename T>
+    void merge(T &s, const T &other) const {
+        add(s, other);
+    }
+    template <typename T>
+    T result(const T &s) const {
+        return s;
+    }
+};
+
+struct max_t {
+    template <typename T>
+    T start(const T &x) const {
+        return x;
+    }
+    template <typename T>
+    void add(T &s, const T &x) const {
+        if (s < x)
+            s = x;
+    }
+    template <typename T>
+    void merge(T &s, const T &other) const {
+        add(s, other);
+    }
+    template <typename T>
+    T result(const T &s) const {
+        return s;
+    }
+};
+
+struct mean_t {
+    struct state {
+        double sum;
+        std::size_t n;
+    };
+
+    template <typename T>
+    state start(const T &x) const {
+        return {double(x), 1};
+    }
+    template <typename T>
+    void add(state &s, const T &x) const {
+        s.sum += double(x);
+        ++s.n;
+    }
+    void merge(state &s, const state &other) const {
+        s.sum += other.sum;
+        s.n += other.n;
+    }
+    double result(const state &s) const { return s.sum / double(s.n); }
+};
+
+/* folds a group's values with op(state, x), in row order; op must also combine two states */
+template <typename Op>
+struct fold_t {
+    Op op;
+
+    template <typename T>
+    T start(const T &x) const {
+        return x;
+    }
+    template <typename S, typename T>
+    void add(S &s, const T &x) const {
+        s = op(std::move(s), x);
+    }
+    template <typename S>
+    void merge(S &s, const S &other) const {
+        s = op(std::move(s), other);
+    }
+    template <typename S>
+    S result(const S &s) const {
+        return s;
+    }
+};
+
+inline constexpr count_t count{};
+inline constexpr sum_t sum{};
+inline constexpr min_t min{};
+inline constexpr max_t max{};
+inline constexpr mean_t mean{};
+
+template <typename Op>
+fold_t<Op> fold(Op op) {
+    return {std::move(op)};
+}
+} // namespace aggregate
+
+namespace detail {
+/* std::hash is the identity on integers in the common standard libraries, so its bits get
+ * mixed with murmur3's finalizer before they pick a slot
+ */
+inline std::uint64_t mix_hash(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+template <typename Key>
+std::uint64_t hash_key(const Key &key) {
+    return mix_hash(std::uint64_t(std::hash<Key>()(key)));
+}
+
+/* numbers distinct keys 0, 1, ... in the order they are inserted. the table is swiss table
+ * style: slots come in groups of 8, with a control byte each that is either empty or 7 bits of
+ * the hash of the key in the slot, so that one word compare finds the slots of a group that may
+ * hold a key and probes rarely branch on anything but the first match. the slots hold key
+ * numbers; the keys and their hashes live in dense arrays.
+ */
+template <typename Key>
+class key_index {
+public:
+    static constexpr std::uint32_t none = std::uint32_t(-1);
+
+    std::size_t size() const { return keys_.size(); }
+    const std::vector<Key> &keys() const { return keys_; }
+    const std::vector<std::uint64_t> &hashes() const { return hashes_; }
+
+    /* moves the keys out, after which the index is unusable */
+    std::vector<Key> release_keys() { return std::move(keys_); }
+
+    void reserve(std::size_t n) {
+        if (over_loaded(n))
+            rehash(n);
+        keys_.reserve(n);
+        hashes_.reserve(n);
+    }
+
+    /* the number of key, which gets the next one if it is new; the bool says whether it was */
+    std::pair<std::uint32_t, bool> insert(const Key &key, std::uint64_t hash) {
+        if (over_loaded(size() + 1))
+            rehash(size() + 1);
+        auto tag = std::uint8_t(hash & 0x7f);
+        for (auto g = group_of(hash), step = std::size_t(1);; g = (g + step++) & group_mask_) {
+            auto control = load_group(g);
+            for (auto m = matches(control, tag); m; m &= m - 1) {
+                auto number = numbers_[g * group_size + first_byte(m)];
+                if (keys_[number] == key)
+                    return {number, false};
+            }
+            if (auto empty = control & high_bits) {
+                auto at = g * group_size + first_byte(empty);
+                auto number = std::uint32_t(size());
+                control_[at] = tag;
+                numbers_[at] = number;
+                keys_.push_back(key);
+                hashes_.push_back(hash);
+                return {number, true};
+            }
+        }
+    }
+
+    /* the number of key, or none */
+    std::uint32_t find(const Key &key, std::uint64_t hash) const {
+        if (control_.empty())
+            return none;
+        auto tag = std::uint8_t(hash & 0x7f);
+        for (auto g = group_of(hash), step = std::size_t(1);; g = (g + step++) & group_mask_) {
+            auto control = load_group(g);
+            for (auto m = matches(control, tag); m; m &= m - 1) {
+                auto number = numbers_[g * group_size + first_byte(m)];
+                if (keys_[number] == key)
+                    return number;
+            }
+            if (control & high_bits)
+                return none;
+        }
+    }
+
+    /* starts loading the slots a find of hash looks at first */
+    void prefetch(std::uint64_t hash) const {
+        if (!control_.empty()) {
+            auto g = group_of(hash);
+            prefetch_address(control_.data() + g * group_size);
+            prefetch_address(numbers_.data() + g * group_size);
+        }
+    }
+
+    static void prefetch_address(const void *p) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#else
+        (void)p;
+#endif
+    }
+
+private:
+    static constexpr std::size_t group_size = 8;
+    static constexpr std::uint8_t empty_byte = 0x80;
+    static constexpr std::uint64_t low_bits = 0x0101010101010101ull;
+    static constexpr std::uint64_t high_bits = 0x8080808080808080ull;
+
+    /* at most 7 of every 8 slots are used */
+    bool over_loaded(std::size_t n) const { return 8 * n > 7 * control_.size(); }
+
+    std::size_t group_of(std::uint64_t hash) const { return std::size_t(hash >> 7) & group_mask_; }
+
+    /* a group's control bytes, the first one lowest */
+    std::uint64_t load_group(std::size_t g) const {
+        auto bytes = control_.data() + g * group_size;
+        std::uint64_t control;
+        std::memcpy(&control, bytes, sizeof(control));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        control = __builtin_bswap64(control);
+#endif
+        return control;
+    }
+
+    /* the high bit of every byte equal to tag, and maybe of some above one that is, which
+     * costs a key compare but never misses
+     */
+    static std::uint64_t matches(std::uint64_t control, std::uint8_t tag) {
+        auto x = control ^ (low_bits * tag);
+        return (x - low_bits) & ~x & high_bits;
+    }
+
+    /* the byte of the lowest high bit in m, which isn't 0 */
+    static std::size_t first_byte(std::uint64_t m) {
+#if defined(__GNUC__) || defined(__clang__)
+        return std::size_t(__builtin_ctzll(m)) / 8;
+#else
+        std::size_t i = 0;
+        while (!(m & 0x80)) {
+            m >>= 8;
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    /* grows to fit n keys, placing the existing ones from their stored hashes */
+    void rehash(std::size_t n) {
+        auto groups = std::size_t(2);
+        while (7 * groups * group_size < 8 * n)
+            groups *= 2;
+        control_.assign(groups * group_size, empty_byte);
+        numbers_.assign(groups * group_size, none);
+        group_mask_ = groups - 1;
+        for (std::uint32_t k = 0; k != size(); ++k) {
+            auto hash = hashes_[k];
+            for (auto g = group_of(hash), step = std::size_t(1);; g = (g + step++) & group_mask_) {
+                if (auto empty = load_group(g) & high_bits) {
+                    auto at = g * group_size + first_byte(empty);
+                    control_[at] = std::uint8_t(hash & 0x7f);
+                    numbers_[at] = k;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<std::uint8_t> control_;
+    std::vector<std::uint32_t> numbers_;
+    std::size_t group_mask_ = 0;
+    std::vector<Key> keys_;
+    std::vector<std::uint64_t> hashes_;
+};
+
+template <typename T, typename = void>
+constexpr bool is_iterable = false;
+
+template <typename T>
+constexpr bool is_iterable<T, std::void_t<decltype(std::begin(std::declval<T &>()))>> = true;
+
+template <typename It, std::size_t I>
+using column_t = std::decay_t<std::tuple_element_t<I, iter_value_t<It>>>;
+
+template <typename A, typename T>
+using aggregate_state_t =
+    std::decay_t<decltype(std::declval<const A &>().start(std::declval<const T &>()))>;
+
+template <typename A, typename T>
+using aggregate_result_t = std::decay_t<decltype(std::declval<const A &>().result(
+    std::declval<const aggregate_state_t<A, T> &>()))>;
+
+/* the groups of a part of the table: their keys, and one state per aggregator */
+template <typename Key, typename... States>
+struct group_table {
+    key_index<Key> index;
+    std::tuple<std::vector<States>...> states;
+};
+
+template <typename It, typename... Aggregators, std::size_t... I>
+auto group_table_for(std::index_sequence<I...>)
+    -> group_table<column_t<It, 0>, aggregate_state_t<Aggregators, column_t<It, I + 1>>...>;
+
+template <typename It, typename... Aggregators>
+using group_table_t = decltype(group_table_for<It, Aggregators...>(
+    std::index_sequence_for<Aggregators...>()));
+
+template <typename It, typename... Aggregators, std::size_t... I>
+auto group_result_for(std::index_sequence<I...>)
+    -> std::tuple<std::vector<column_t<It, 0>>,
+                  std::vector<aggregate_result_t<Aggregators, column_t<It, I + 1>>>...>;
+
+template <typename It, typename... Aggregators>
+using group_result_t = decltype(group_result_for<It, Aggregators...>(
+    std::index_sequence_for<Aggregators...>()));
+
+template <typename Table, typename It, typename Aggregators, std::size_t... I>
+void aggregate_rows(Table &table, It first, It last, const Aggregators &aggs,
+                    std::index_sequence<I...>) {
+    for (; first != last; ++first) {
+        auto &&row = *first;
+        const auto &key = std::get<0>(row);
+        auto inserted = table.index.insert(key, hash_key(key));
+        if (inserted.second)
+            (std::get<I>(table.states).push_back(std::get<I>(aggs).start(std::get<I + 1>(row))),
+             ...);
+        else
+            (std::get<I>(aggs).add(std::get<I>(table.states)[inserted.first],
+                                   std::get<I + 1>(row)),
+             ...);
+    }
+}
+
+template <typename Result, typename Table, typename Aggregators, std::size_t... I>
+Result group_results(Table &table, const Aggregators &aggs, std::index_sequence<I...>) {
+    auto result = Result();
+    auto n = table.index.size();
+    std::get<0>(result) = table.index.release_keys();
+    ((std::get<I + 1>(result).reserve(n), ...));
+    for (std::size_t g = 0; g != n; ++g)
+        (std::get<I + 1>(result).push_back(std::get<I>(aggs).result(std::get<I>(table.states)[g])),
+         ...);
+    return result;
+}
+
+/* adds group g of a chunk's table to a merged table, where it was just inserted */
+template <typename Table, typename Aggregators, std::size_t... I>
+void merge_group(Table &to, std::pair<std::uint32_t, bool> inserted, Table &from, std::uint32_t g,
+                 const Aggregators &aggs, std::index_sequence<I...>) {
+    if (inserted.second)
+        (std::get<I>(to.states).push_back(std::move(std::get<I>(from.states)[g])), ...);
+    else
+        (std::get<I>(aggs).merge(std::get<I>(to.states)[inserted.first],
+                                 std::get<I>(from.states)[g]),
+         ...);
+}
+
+template <typename Result, typename Table, typename Aggregators, std::size_t... I>
+void place_group(Result &result, std::size_t at, const Table &table, std::size_t g,
+                 const Aggregators &aggs, std::index_sequence<I...>) {
+    ((std::get<I + 1>(result)[at] = std::get<I>(aggs).result(std::get<I>(table.states)[g])), ...);
+}
+
+template <typename It, typename... Aggregators>
+void check_group_by() {
+    static_assert(std::tuple_size_v<iter_value_t<It>> == sizeof...(Aggregators) + 1,
+                  "group_by takes a key column and one aggregator per value column");
+}
+} // namespace detail
+
+/* groups the rows of a table, a zip of a key column and value columns, by key, and aggregates
+ * each value column with its aggregator. the result is a table of columns: the distinct keys, in
+ * the order they first appear, and each aggregator's results.
+ */
+template <typename InRange, typename... Aggregators,
+          std::enable_if_t<detail::is_iterable<InRange>, int> = 0>
+auto group_by(InRange &&in_range, Aggregators... aggs) {
+    using std::begin;
+    using std::end;
+    using It = decltype(begin(in_range));
+
+    detail::check_group_by<It, Aggregators...>();
+    auto seq = std::index_sequence_for<Aggregators...>();
+    auto table = detail::group_table_t<It, Aggregators...>();
+    detail::aggregate_rows(table, begin(in_range), end(in_range), std::tie(aggs...), seq);
+    return detail::group_results<detail::group_result_t<It, Aggregators...>>(
+        table, std::tie(aggs...), seq);
+}
+
+/* group_by on a pool. every task aggregates a chunk of the rows into its own table; the chunks'
+ * groups are then split into partitions by hash, which merge on their own, in chunk order, so
+ * that the result, order included, is the serial one. merged aggregators have to be
+ * associative, and the keys and results default constructible.
+ */
+template <typename Pool, typename InRange, typename... Aggregators,
+          std::enable_if_t<not detail::is_iterable<Pool>, int> = 0>
+auto group_by(Pool &pool, InRange &&in_range, Aggregators... aggs) {
+    using std::begin;
+    using std::end;
+    using It = decltype(begin(in_range));
+    using table_t = detail::group_table_t<It, Aggregators...>;
+    using result_t = detail::group_result_t<It, Aggregators...>;
+
+    static_assert(detail::is_random_access<iterator_category_t<It>>,
+                  "group_by on a pool needs random access rows");
+    detail::check_group_by<It, Aggregators...>();
+    auto first = begin(in_range);
+    auto n = std::size_t(end(in_range) - first);
+    auto seq = std::index_sequence_for<Aggregators...>();
+    auto agg_refs = std::tie(aggs...);
+
+    auto chunks = detail::chunking(n, detail::concurrency(pool), std::size_t(1) << 16);
+    if (chunks.chunks == 1)
+        return group_by(in_range, aggs...);
+    auto n_chunks = chunks.chunks;
+    auto locals = std::vector<table_t>(n_chunks);
+
+    /* a few partitions per chunk, numbered by the top bits of the hash */
+    unsigned bits = 0;
+    while ((std::size_t(1) << bits) < 4 * n_chunks)
+        ++bits;
+    auto n_parts = std::size_t(1) << bits;
+    auto part_of = [bits](std::uint64_t hash) { return std::size_t(hash >> (64 - bits)); };
+
+    /* members[c] has chunk c's groups sorted by partition, those of p from offsets[c][p] */
+    auto members = std::vector<std::vector<std::uint32_t>>(n_chunks);
+    auto offsets = std::vector<std::vector<std::size_t>>(n_chunks);
+    detail::run_chunks(pool, n_chunks, [&](std::size_t c) {
+        auto &local = locals[c];
+        detail::aggregate_rows(local, first + chunks.bound(c), first + chunks.bound(c + 1),
+                               agg_refs, seq);
+        auto &hashes = local.index.hashes();
+        auto &offset = offsets[c];
+        offset.assign(n_parts + 1, 0);
+        for (auto h : hashes)
+            ++offset[part_of(h) + 1];
+        for (std::size_t p = 0; p != n_parts; ++p)
+            offset[p + 1] += offset[p];
+        auto fill = std::vector<std::size_t>(offset.begin(), offset.end() - 1);
+        members[c].resize(hashes.size());
+        for (std::uint32_t g = 0; g != hashes.size(); ++g)
+            members[c][fill[part_of(hashes[g])]++] = g;
+    });
+
+    /* a merged group is owned by the first chunk it appears in; ranks[c][g] is first 1 for the
+     * groups chunk c owns, and after the scan below their place among them
+     */
+    auto merged = std::vector<table_t>(n_parts);
+    auto owners = std::vector<std::vector<std::pair<std::uint32_t, std::uint32_t>>>(n_parts);
+    auto ranks = std::vector<std::vector<std::uint32_t>>(n_chunks);
+    for (std::size_t c = 0; c != n_chunks; ++c)
+        ranks[c].assign(locals[c].index.size(), 0);
+    detail::run_chunks(pool, n_parts, [&](std::size_t p) {
+        auto &table = merged[p];
+        for (std::uint32_t c = 0; c != n_chunks; ++c) {
+            auto &local = locals[c];
+            for (auto i = offsets[c][p]; i != offsets[c][p + 1]; ++i) {
+                auto g = members[c][i];
+                auto inserted = table.index.insert(local.index.keys()[g], local.index.hashes()[g]);
+                if (inserted.second) {
+                    owners[p].emplace_back(c, g);
+                    ranks[c][g] = 1;
+                }
+                detail::merge_group(table, inserted, local, g, agg_refs, seq);
+            }
+        }
+    });
+
+    auto starts = std::vector<std::size_t>(n_chunks + 1, 0);
+    detail::run_chunks(pool, n_chunks, [&](std::size_t c) {
+        std::uint32_t rank = 0;
+        for (auto &r : ranks[c])
+            r = (rank += r) - 1;
+        starts[c + 1] = rank;
+    });
+    for (std::size_t c = 0; c != n_chunks; ++c)
+        starts[c + 1] += starts[c];
+
+    auto result = result_t();
+    std::apply([&](auto &...columns) { (columns.resize(starts[n_chunks]), ...); }, result);
+    detail::run_chunks(pool, n_parts, [&](std::size_t p) {
+        auto &table = merged[p];
+        auto keys = table.index.release_keys();
+        for (std::size_t m = 0; m != keys.size(); ++m) {
+            auto [c, g] = owners[p][m];
+            auto at = starts[c] + ranks[c][g];
+            std::get<0>(result)[at] = std::move(keys[m]);
+            detail::place_group(result, at, table, m, agg_refs, seq);
+        }
+    });
+    return result;
+}
+
+namespace detail {
+/* rows of one side of a join, materialized as their keys, hashes and row numbers, and sorted
+ * into partitions by the top bits of the hash; partition p is [bounds[p], bounds[p + 1])
+ */
+template <typename Key>
+struct partitioned_rows {
+    scratch_vector<Key> keys;
+    scratch_vector<std::uint64_t> hashes;
+    scratch_vector<std::size_t> rows;
+    std::vector<std::size_t> bounds;
+
+    explicit partitioned_rows(std::pmr::memory_resource *resource)
+      : keys(resource), hashes(resource), rows(resource) {}
+};
+
+inline std::size_t partition_of(std::uint64_t hash, unsigned bits) {
+    return bits == 0 ? 0 : std::size_t(hash >> (64 - bits));
+}
+
+/* a radix partitioning pass: every chunk hashes its rows and counts them per partition, and
+ * then scatters them to where the counts of the chunks before it say they go, so that every
+ * partition keeps the rows in order
+ */
+template <typename Key, typename Pool, typename It, typename KeyOf>
+partitioned_rows<Key> partition_rows(Pool &pool, It first, std::size_t n, const KeyOf &key_of,
+                                     unsigned bits) {
+    auto parts = std::size_t(1) << bits;
+    auto chunks = chunking(n, concurrency(pool), std::size_t(1) << 16);
+    auto counts = std::vector<std::vector<std::size_t>>(chunks.chunks);
+    auto out = partitioned_rows<Key>(scratch_resource(pool));
+    out.keys.resize(n);
+    out.hashes.resize(n);
+    out.rows.resize(n);
+
+    /* the hashes go where the rows are for now, and move with them in the scatter */
+    auto row_hashes = scratch_vector<std::uint64_t>(n, scratch_resource(pool));
+    run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        auto &count = counts[c];
+        count.assign(parts, 0);
+        for (auto i = chunks.bound(c); i != chunks.bound(c + 1); ++i) {
+            row_hashes[i] = hash_key(Key(key_of(first[i])));
+            ++count[partition_of(row_hashes[i], bits)];
+        }
+    });
+
+    out.bounds.assign(parts + 1, 0);
+    std::size_t at = 0;
+    for (std::size_t p = 0; p != parts; ++p) {
+        out.bounds[p] = at;
+        for (auto &count : counts) {
+            auto here = count[p];
+            count[p] = at;
+            at += here;
+        }
+    }
+    out.bounds[parts] = at;
+
+    run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        auto &next = counts[c];
+        for (auto i = chunks.bound(c); i != chunks.bound(c + 1); ++i) {
+            auto to = next[partition_of(row_hashes[i], bits)]++;
+            out.keys[to] = Key(key_of(first[i]));
+            out.hashes[to] = row_hashes[i];
+            out.rows[to] = i;
+        }
+    });
+    return out;
+}
+
+/* a partition of the build side: its distinct keys, and the rows of key k, in order, at
+ * rows[starts[k]] to rows[starts[k + 1]]
+ */
+template <typename Key>
+struct join_table {
+    key_index<Key> index;
+    scratch_vector<std::uint32_t> starts;
+    scratch_vector<std::size_t> rows;
+
+    explicit join_table(std::pmr::memory_resource *resource) : starts(resource), rows(resource) {}
+
+    void build(const partitioned_rows<Key> &side, std::size_t lo, std::size_t hi) {
+        auto numbers = scratch_vector<std::uint32_t>(hi - lo, starts.get_allocator());
+        for (auto i = lo; i != hi; ++i)
+            numbers[i - lo] = index.insert(side.keys[i], side.hashes[i]).first;
+        starts.assign(index.size() + 1, 0);
+        for (auto k : numbers)
+            ++starts[k + 1];
+        for (std::size_t k = 0; k != index.size(); ++k)
+            starts[k + 1] += starts[k];
+        auto next =
+            scratch_vector<std::uint32_t>(starts.begin(), starts.end() - 1, starts.get_allocator());
+        rows.resize(hi - lo);
+        for (auto i = lo; i != hi; ++i)
+            rows[next[numbers[i - lo]]++] = side.rows[i];
+    }
+};
+
+/* partitions of about this many build rows, whose tables fit in a core's l2 cache */
+constexpr std::size_t join_partition_rows = std::size_t(1) << 13;
+constexpr unsigned max_join_partition_bits = 12;
+
+/* probe rows are hashed and their slots prefetched this many at a time, so that the cache
+ * misses of a batch overlap
+ */
+constexpr std::size_t join_probe_batch = 16;
+
+template <typename Pool, typename BuildRange, typename ProbeRange, typename KeyOf>
+std::tuple<std::vector<std::size_t>, std::vector<std::size_t>>
+hash_join(Pool &pool, BuildRange &&build_range, ProbeRange &&probe_range, const KeyOf &key_of) {
+    using std::begin;
+    using std::end;
+    using BuildIt = decltype(begin(build_range));
+    using ProbeIt = decltype(begin(probe_range));
+    using Key = std::decay_t<decltype(key_of(*std::declval<BuildIt>()))>;
+    using result_t = std::tuple<std::vector<std::size_t>, std::vector<std::size_t>>;
+
+    static_assert(is_random_access<iterator_category_t<BuildIt>> and
+                      is_random_access<iterator_category_t<ProbeIt>>,
+                  "hash_join needs random access rows");
+    auto build_first = begin(build_range);
+    auto probe_first = begin(probe_range);
+    auto n_build = std::size_t(end(build_range) - build_first);
+    auto n_probe = std::size_t(end(probe_range) - probe_first);
+
+    unsigned bits = 0;
+    while (bits != max_join_partition_bits and (join_partition_rows << bits) < n_build)
+        ++bits;
+    auto parts = std::size_t(1) << bits;
+    auto build = partition_rows<Key>(pool, build_first, n_build, key_of, bits);
+    auto tables = std::vector<join_table<Key>>();
+    tables.reserve(parts);
+    for (std::size_t p = 0; p != parts; ++p)
+        tables.emplace_back(scratch_resource(pool));
+    auto build_tasks = chunking(parts, 4 * concurrency(pool), 1);
+    run_chunks(pool, build_tasks.chunks, [&](std::size_t t) {
+        for (auto p = build_tasks.bound(t); p != build_tasks.bound(t + 1); ++p)
+            tables[p].build(build, build.bounds[p], build.bounds[p + 1]);
+    });
+    build = partitioned_rows<Key>(scratch_resource(pool));
+
+    /* the probe side streams through the tables in chunks, each with its own matches */
+    auto chunks = chunking(n_probe, concurrency(pool), std::size_t(1) << 16);
+    auto matches = std::vector<result_t>(chunks.chunks);
+    run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        auto &build_rows = std::get<0>(matches[c]);
+        auto &probe_rows = std::get<1>(matches[c]);
+        /* room for a match per row, the common case of a foreign key, which costs nothing
+         * until it is written
+         */
+        build_rows.reserve(chunks.bound(c + 1) - chunks.bound(c));
+        probe_rows.reserve(chunks.bound(c + 1) - chunks.bound(c));
+        Key keys[join_probe_batch];
+        std::uint64_t hashes[join_probe_batch];
+        const join_table<Key> *found[join_probe_batch];
+        std::uint32_t numbers[join_probe_batch];
+        for (auto lo = chunks.bound(c), hi = chunks.bound(c + 1); lo != hi;) {
+            /* every step over the batch loads what the next one reads */
+            auto batch = std::min(join_probe_batch, hi - lo);
+            for (std::size_t b = 0; b != batch; ++b) {
+                keys[b] = Key(key_of(probe_first[lo + b]));
+                hashes[b] = hash_key(keys[b]);
+                found[b] = &tables[partition_of(hashes[b], bits)];
+                found[b]->index.prefetch(hashes[b]);
+            }
+            for (std::size_t b = 0; b != batch; ++b) {
+                numbers[b] = found[b]->index.find(keys[b], hashes[b]);
+                if (numbers[b] != found[b]->index.none)
+                    found[b]->index.prefetch_address(found[b]->starts.data() + numbers[b]);
+            }
+            for (std::size_t b = 0; b != batch; ++b)
+                if (numbers[b] != found[b]->index.none)
+                    found[b]->index.prefetch_address(found[b]->rows.data() +
+                                                     found[b]->starts[numbers[b]]);
+            for (std::size_t b = 0; b != batch; ++b) {
+                if (numbers[b] == found[b]->index.none)
+                    continue;
+                auto &table = *found[b];
+                for (auto j = table.starts[numbers[b]]; j != table.starts[numbers[b] + 1]; ++j) {
+                    build_rows.push_back(table.rows[j]);
+                    probe_rows.push_back(lo + b);
+                }
+            }
+            lo += batch;
+        }
+    });
+    if (chunks.chunks == 1)
+        return std::move(matches[0]);
+
+    auto starts = std::vector<std::size_t>(chunks.chunks + 1, 0);
+    for (std::size_t c = 0; c != chunks.chunks; ++c)
+        starts[c + 1] = starts[c] + std::get<0>(matches[c]).size();
+    auto result = result_t();
+    std::get<0>(result).resize(starts[chunks.chunks]);
+    std::get<1>(result).resize(starts[chunks.chunks]);
+    run_chunks(pool, chunks.chunks, [&](std::size_t c) {
+        auto &[build_rows, probe_rows] = matches[c];
+        std::copy(build_rows.begin(), build_rows.end(), std::get<0>(result).begin() + starts[c]);
+        std::copy(probe_rows.begin(), probe_rows.end(), std::get<1>(result).begin() + starts[c]);
+        matches[c] = {};
+    });
+    return result;
+}
+} // namespace detail
+
+/* joins two tables, usually zips of columns, on equal keys, key_of(row) for a row of either.
+ * the result is two columns of the row numbers of the matches, build side then probe side, in
+ * probe side order and then build side order. the build side, which should be the smaller one,
+ * is radix partitioned by hash into partitions whose hash tables fit in cache; the probe side
+ * streams through them without being copied.
+ */
+template <typename BuildRange, typename ProbeRange, typename KeyOf>
+auto hash_join(BuildRange &&build_range, ProbeRange &&probe_range, KeyOf key_of) {
+    auto pool = detail::no_pool();
+    return detail::hash_join(pool, build_range, probe_range, key_of);
+}
+
+/* hash_join on a pool, which partitions and joins in parallel; the result is the serial one */
+template <typename Pool, typename BuildRange, typename ProbeRange, typename KeyOf>
+auto hash_join(Pool &pool, BuildRange &&build_range, ProbeRange &&probe_range, KeyOf key_of) {
+    return detail::hash_join(pool, build_range, probe_range, key_of);
+}
+} // namespace drift
@@ -0,0 +1,468 @@
+/* vectorized kernels for contiguous ranges of arithmetic types.
+ *
+ * Copyright (c) 2026 - present, Leandro Medina de Oliveira
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR \
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * --- Optional exception to the license ---
+ *
+ * As an exception, if, as a result of your compiling your source code, portions
+ * of this Software are embedded into a machine-executable object form of such
+ * source code, you may redistribute such embedded portions in such object form
+ * without including the above copyright and permission notices.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/* the kernels are written once with gcc/clang vector extensions and compiled for sse2, avx2
+ * and avx-512 through target attributes; the widest one the cpu supports is picked at run
+ * time. other compilers and architectures get the scalar kernels.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DRIFT_SIMD_X86 1
+#define DRIFT_SIMD_INLINE __attribute__((always_inline)) inline
+#else
+#define DRIFT_SIMD_X86 0
+#endif
+
+namespace drift {
+namespace simd {
+
+enum class isa { scalar, sse2, avx2, avx512 };
+
+/* integral and floating point types, other than bool and long double */
+template <typename T>
+constexpr bool is_vectorizable =
+    std::is_arithmetic_v<T> and !std::is_same_v<T, bool> and
+    (sizeof(T) == 1 or sizeof(T) == 2 or sizeof(T) == 4 or sizeof(T) == 8) and
+    (std::is_integral_v<T> or std::is_same_v<T, float> or std::is_same_v<T, double>);
+
+template <typename T>
+struct extrema {
+    T min, max;
+    /* true if there were nans, in which case min and max mean nothing */
+    bool unordered;
+};
+
+namespace detail {
+inline isa detect_isa() {
+#if DRIFT_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx512bw") and
+        __builtin_cpu_supports("avx512dq"))
+        return isa::avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return isa::avx2;
+    if (__builtin_cpu_supports("sse2"))
+        return isa::sse2;
+#endif
+    return isa::scalar;
+}
+
+inline std::atomic<isa> isa_limit{isa::avx512};
+
+template <std::size_t Size>
+using uint_t = std::conditional_t<
+    Size == 1, std::uint8_t,
+    std::conditional_t<Size == 2, std::uint16_t,
+                       std::conditional_t<Size == 4, std::uint32_t, std::uint64_t>>>;
+
+template <std::size_t Size>
+using int_t = std::make_signed_t<uint_t<Size>>;
+
+/* the lane type T is computed in: floats as they are, integers as fixed width ones */
+template <typename T>
+using lane_t = std::conditional_t<std::is_floating_point_v<T>, T,
+                                  std::conditional_t<std::is_signed_v<T>, int_t<sizeof(T)>,
+                                                     uint_t<sizeof(T)>>>;
+
+/* wrapping arithmetic for sums: the result of std::accumulate whenever that is defined */
+template <typename T>
+T from_bits(uint_t<sizeof(T)> u) {
+    T t;
+    std::memcpy(&t, &u, sizeof(T));
+    return t;
+}
+
+struct scalar_kernels {
+    template <typename T>
+    static std::size_t count(const T *p, std::size_t n, T x) {
+        return std::size_t(std::count(p, p + n, x));
+    }
+
+    template <typename T>
+    static std::size_t find(const T *p, std::size_t n, T x) {
+        return std::size_t(std::find(p, p + n, x) - p);
+    }
+
+    template <typename T>
+    static std::size_t find_last(const T *p, std::size_t n, T x) {
+        for (auto i = n; i != 0; --i)
+            if (p[i - 1] == x)
+                return i - 1;
+        return n;
+    }
+
+    template <typename T>
+    static extrema<T> minmax(const T *p, std::size_t n) {
+        auto e = extrema<T>{p[0], p[0], false};
+        for (std::size_t i = 0; i != n; ++i) {
+            e.min = p[i] < e.min ? p[i] : e.min;
+            e.max = e.max < p[i] ? p[i] : e.max;
+            e.unordered = e.unordered or p[i] != p[i];
+        }
+        return e;
+    }
+
+    template <typename T>
+    static T sum(const T *p, std::size_t n, T init) {
+        using U = uint_t<sizeof(T)>;
+        auto acc = U(init);
+        for (std::size_t i = 0; i != n; ++i)
+            acc = U(acc + U(p[i]));
+        return from_bits<T>(acc);
+    }
+
+    template <typename T>
+    static T dot(const T *a, const T *b, std::size_t n, T init) {
+        using U = uint_t<sizeof(T)>;
+        auto acc = std::uint64_t(U(init));
+        for (std::size_t i = 0; i != n; ++i)
+            acc += std::uint64_t(U(a[i])) * std::uint64_t(U(b[i]));
+        return from_bits<T>(U(acc));
+    }
+};
+
+#if DRIFT_SIMD_X86
+template <typename T, int Bytes>
+struct vector {
+    typedef T type __attribute__((vector_size(Bytes)));
+};
+
+template <typename T, int Bytes>
+using vector_t = typename vector<T, Bytes>::type;
+
+/* the helpers below return and take wide vectors, which gcc warns about when they aren't
+ * compiled for the matching target. they are always inlined into one, so no call with those
+ * vectors ever happens.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+template <typename V, typename T>
+DRIFT_SIMD_INLINE V load(const T *p) {
+    V v;
+    std::memcpy(&v, p, sizeof(V));
+    return v;
+}
+
+template <int Bytes, typename U>
+DRIFT_SIMD_INLINE bool any_lane(const U &m) {
+    using W = vector_t<std::uint64_t, Bytes>;
+    auto w = (W)m;
+    std::uint64_t r = 0;
+    for (int l = 0; l != Bytes / 8; ++l)
+        r |= w[l];
+    return r != 0;
+}
+
+template <int Bytes, typename T>
+DRIFT_SIMD_INLINE std::size_t count_kernel(const T *p, std::size_t n, T x) {
+    using L = lane_t<T>;
+    using V = vector_t<L, Bytes>;
+    using U = vector_t<uint_t<sizeof(T)>, Bytes>;
+    constexpr std::size_t lanes = Bytes / sizeof(T);
+    /* narrow lane counters are flushed before they can wrap */
+    constexpr std::size_t batch =
+        sizeof(T) < 4 ? (std::size_t(1) << 8 * sizeof(T)) - 1 : std::size_t(1) << 24;
+
+    auto s = V{} + L(x);
+    std::size_t total = 0, i = 0;
+    while (n - i >= lanes) {
+        auto acc = U{};
+        auto stop = i + lanes * std::min(batch, (n - i) / lanes);
+        for (; i != stop; i += lanes)
+            acc -= (U)(load<V>(p + i) == s);
+        for (std::size_t l = 0; l != lanes; ++l)
+            total += acc[l];
+    }
+    for (; i != n; ++i)
+        total += p[i] == x;
+    return total;
+}
+
+template <int Bytes, typename T>
+DRIFT_SIMD_INLINE std::size_t find_kernel(const T *p, std::size_t n, T x) {
+    using L = lane_t<T>;
+    using V = vector_t<L, Bytes>;
+    using U = vector_t<uint_t<sizeof(T)>, Bytes>;
+    constexpr std::size_t lanes = Bytes / sizeof(T);
+
+    auto s = V{} + L(x);
+    std::size_t i = 0;
+    for (; n - i >= 4 * lanes; i += 4 * lanes) {
+        auto m = (U)(load<V>(p + i) == s) |
+                 (U)(load<V>(p + i + lanes) == s) |
+                 (U)(load<V>(p + i + 2 * lanes) == s) |
+                 (U)(load<V>(p + i + 3 * lanes) == s);
+        if (any_lane<Bytes>(m))
+            break;
+    }
+    for (; n - i >= lanes; i += lanes)
+        if (any_lane<Bytes>((U)(load<V>(p + i) == s)))
+            break;
+    for (; i != n; ++i)
+        if (p[i] == x)
+            return i;
+    return n;
+}
+
+template <int Bytes, typename T>
+DRIFT_SIMD_INLINE std::size_t find_last_kernel(const T *p, std::size_t n, T x) {
+    using L = lane_t<T>;
+    using V = vector_t<L, Bytes>;
+    using U = vector_t<uint_t<sizeof(T)>, Bytes>;
+    constexpr std::size_t lanes = Bytes / sizeof(T);
+
+    auto s = V{} + L(x);
+    auto i = n;
+    for (; i >= lanes; i -= lanes)
+        if (any_lane<Bytes>((U)(load<V>(p + i - lanes) == s)))
+            break;
+    for (; i != 0; --i)
+        if (p[i - 1] == x)
+            return i - 1;
+    return n;
+}
+
+template <int Bytes, typename T>
+DRIFT_SIMD_INLINE extrema<T> minmax_kernel(const T *p, std::size_t n) {
+    using L = lane_t<T>;
+    using V = vector_t<L, Bytes>;
+    using M = vector_t<int_t<sizeof(T)>, Bytes>;
+    constexpr std::size_t lanes = Bytes / sizeof(T);
+
+    if (n < lanes)
+        return scalar_kernels::minmax(p, n);
+
+    auto lo = load<V>(p), hi = lo;
+    auto nan = M{};
+    if constexpr (std::is_floating_point_v<T>)
+        nan = (M)(lo != lo);
+    for (std::size_t i = lanes; n - i >= lanes; i += lanes) {
+        auto v = load<V>(p + i);
+        lo = v < lo ? v : lo;
+        hi = hi < v ? v : hi;
+        if constexpr (std::is_floating_point_v<T>)
+            nan |= (M)(v != v);
+    }
+
+    auto e = extrema<T>{T(lo[0]), T(hi[0]), any_lane<Bytes>(nan)};
+    for (std::size_t l = 1; l != lanes; ++l) {
+        e.min = T(lo[l]) < e.min ? T(lo[l]) : e.min;
+        e.max = e.max < T(hi[l]) ? T(hi[l]) : e.max;
+    }
+    if (n % lanes) {
+        auto tail = scalar_kernels::minmax(p + (n - n % lanes), n % lanes);
+        e.min = tail.min < e.min ? tail.min : e.min;
+        e.max = e.max < tail.max ? tail.max : e.max;
+        e.unordered = e.unordered or tail.unordered;
+    }
+    return e;
+}
+
+template <int Bytes, typename T>
+DRIFT_SIMD_INLINE T sum_kernel(const T *p, std::size_t n, T init) {
+    using U = vector_t<uint_t<sizeof(T)>, Bytes>;
+    constexpr std::size_t lanes = Bytes / sizeof(T);
+
+    /* independent accumulators hide the latency of the adds */
+    auto a0 = U{}, a1 = U{}, a2 = U{}, a3 = U{};
+    std::size_t i = 0;
+    for (; n - i >= 4 * lanes; i += 4 * lanes) {
+        a0 += load<U>(p + i);
+        a1 += load<U>(p + i + lanes);
+        a2 += load<U>(p + i + 2 * lanes);
+        a3 += load<U>(p + i + 3 * lanes);
+    }
+    for (; n - i >= lanes; i += lanes)
+        a0 += load<U>(p + i);
+    a0 += a1 + a2 + a3;
+
+    auto acc = uint_t<sizeof(T)>(init);
+    for (std::size_t l = 0; l != lanes; ++l)
+        acc = uint_t<sizeof(T)>(acc + a0[l]);
+    return scalar_kernels::sum(p + i, n - i, from_bits<T>(acc));
+}
+
+template <int Bytes, typename T>
+DRIFT_SIMD_INLINE T dot_kernel(const T *a, const T *b, std::size_t n, T init) {
+    using U = vector_t<uint_t<sizeof(T)>, Bytes>;
+    constexpr std::size_t lanes = Bytes / sizeof(T);
+
+    auto a0 = U{}, a1 = U{};
+    std::size_t i = 0;
+    for (; n - i >= 2 * lanes; i += 2 * lanes) {
+        a0 += load<U>(a + i) * load<U>(b + i);
+        a1 += load<U>(a + i + lanes) * load<U>(b + i + lanes);
+    }
+    for (; n - i >= lanes; i += lanes)
+        a0 += load<U>(a + i) * load<U>(b + i);
+    a0 += a1;
+
+    auto acc = uint_t<sizeof(T)>(init);
+    for (std::size_t l = 0; l != lanes; ++l)
+        acc = uint_t<sizeof(T)>(acc + a0[l]);
+    return scalar_kernels::dot(a + i, b + i, n - i, from_bits<T>(acc));
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#define DRIFT_SIMD_KERNELS(name, bytes, flags)                                               \
+    struct name {                                                                            \
+        template <typename T>                                                                \
+        __attribute__((target(flags)))  static std::size_t count(const T *p, std::size_t n, \
+                                                                  T x) {                    \
+            return count_kernel<bytes>(p, n, x);                                             \
+        }                                                                                    \
+                                                                                             \
+        template <typename T>                                                                \
+        __attribute__((target(flags)))  static std::size_t find(const T *p, std::size_t n,  \
+                                                                 T x) {                     \
+            return find_kernel<bytes>(p, n, x);                                              \
+        }                                                                                    \
+                                                                                             \
+        template <typename T>                                                                \
+        __attribute__((target(flags)))  static std::size_t find_last(const T *p,            \
+                                                                      std::size_t n, T x) { \
+            return find_last_kernel<bytes>(p, n, x);                                         \
+        }                                                                                    \
+                                                                                             \
+        template <typename T>                                                                \
+        __attribute__((target(flags)))  static extrema<T> minmax(const T *p, std::size_t n) { \
+            return minmax_kernel<bytes>(p, n);                                               \
+        }                                                                                    \
+                                                                                             \
+        template <typename T>                                                                \
+        __attribute__((target(flags)))  static T sum(const T *p, std::size_t n, T init) {   \
+            return sum_kernel<bytes>(p, n, init);                                            \
+        }                                                                                    \
+                                                                                             \
+        template <typename T>                                                                \
+        __attribute__((target(flags)))  static T dot(const T *a, const T *b, std::size_t n, \
+                                                      T init) {                             \
+            return dot_kernel<bytes>(a, b, n, init);                                         \
+        }                                                                                    \
+    };
+
+DRIFT_SIMD_KERNELS(sse2_kernels, 16, "sse2")
+DRIFT_SIMD_KERNELS(avx2_kernels, 32, "avx2")
+DRIFT_SIMD_KERNELS(avx512_kernels, 64, "avx512f,avx512bw,avx512dq")
+
+#undef DRIFT_SIMD_KERNELS
+#endif
+
+template <typename F>
+decltype(auto) dispatch(isa target, F &&f);
+} // namespace detail
+
+/* the widest instruction set the cpu supports */
+inline isa supported_isa() {
+    static const auto best = detail::detect_isa();
+    return best;
+}
+
+/* caps the instruction set the kernels use, e.g. to compare them against each other */
+inline void limit_isa(isa limit) { detail::isa_limit.store(limit, std::memory_order_relaxed); }
+
+/* the instruction set the kernels use */
+inline isa active_isa() {
+    return std::min(supported_isa(), detail::isa_limit.load(std::memory_order_relaxed));
+}
+
+namespace detail {
+template <typename F>
+decltype(auto) dispatch(isa target, F &&f) {
+    switch (target) {
+#if DRIFT_SIMD_X86
+    case isa::avx512:
+        return f(avx512_kernels());
+    case isa::avx2:
+        return f(avx2_kernels());
+    case isa::sse2:
+        return f(sse2_kernels());
+#endif
+    default:
+        return f(scalar_kernels());
+    }
+}
+} // namespace detail
+
+/* the kernels below give the same results as std::count, std::find, ... on [p, p + n),
+ * with the integer sums wrapping around as they do in std::accumulate. floating point
+ * sums are left out: vectorizing them would change their rounding.
+ */
+template <typename T>
+std::size_t count(const T *p, std::size_t n, T x) {
+    return detail::dispatch(active_isa(), [&](auto k) { return k.count(p, n, x); });
+}
+
+/* index of the first element equal to x, or n */
+template <typename T>
+std::size_t find(const T *p, std::size_t n, T x) {
+    return detail::dispatch(active_isa(), [&](auto k) { return k.find(p, n, x); });
+}
+
+/* index of the last element equal to x, or n */
+template <typename T>
+std::size_t find_last(const T *p, std::size_t n, T x) {
+    return detail::dispatch(active_isa(), [&](auto k) { return k.find_last(p, n, x); });
+}
+
+/* smallest and largest of n > 0 elements */
+template <typename T>
+extrema<T> minmax(const T *p, std::size_t n) {
+    return detail::dispatch(active_isa(), [&](auto k) { return k.minmax(p, n); });
+}
+
+template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+T sum(const T *p, std::size_t n, T init) {
+    return detail::dispatch(active_isa(), [&](auto k) { return k.sum(p, n, init); });
+}
+
+template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+T dot(const T *a, const T *b, std::size_t n, T init) {
+    return detail::dispatch(active_isa(), [&](auto k) { return k.dot(a, b, n, init); });
+}
+
+} // namespace simd
+} // namespace drift
+
+#undef DRIFT_SIMD_INLINE
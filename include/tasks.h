@@ -30,13 +30,18 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <future>
+#include <memory_resource>
 #include <mutex>
+#include <new>
 #include <optional>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace drift {
@@ -46,15 +51,405 @@ std::decay_t<T> decay_copy(T &&v) {
     return std::forward<T>(v);
 }
 
+/* serializes the calls to a memory resource that isn't thread safe, such as a
+ * std::pmr::monotonic_buffer_resource, so that the threads of a pool can share it
+ */
+class synchronized_resource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource *upstream_;
+    std::mutex mutex_;
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        auto lock = std::lock_guard<std::mutex>(mutex_);
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        auto lock = std::lock_guard<std::mutex>(mutex_);
+        upstream_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit synchronized_resource(std::pmr::memory_resource *upstream) : upstream_(upstream) {}
+
+    std::pmr::memory_resource *upstream_resource() const noexcept { return upstream_; }
+};
+
+/* a memory resource for the small objects of tasks, which one thread allocates and another
+ * frees, the worst case for most mallocs. every thread gets its own free lists, one per size,
+ * carved out of chunks from upstream. a block freed away from the thread whose chunk it came
+ * from waits in a batch, which goes back to that thread's inbox in one atomic push when it is
+ * full; the home thread takes the whole inbox when its free list runs out. larger blocks come
+ * straight from upstream. when a thread exits, its batches are pushed home and its cache goes
+ * to an orphan list, for the next new thread to adopt, so there are never more caches than
+ * threads alive at once. chunks go back upstream only when the resource is destroyed.
+ */
+class thread_caching_resource : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t max_block = 256;
+
+    explicit thread_caching_resource(
+        std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+      : upstream_(upstream) {
+        auto &r = registry();
+        auto lock = std::lock_guard<std::mutex>(r.mutex);
+        r.live.push_back({id_, this});
+    }
+
+    thread_caching_resource(const thread_caching_resource &) = delete;
+    thread_caching_resource &operator=(const thread_caching_resource &) = delete;
+
+    ~thread_caching_resource() override {
+        {
+            auto &r = registry();
+            auto lock = std::lock_guard<std::mutex>(r.mutex);
+            for (auto &e : r.live) {
+                if (e.id == id_) {
+                    e = r.live.back();
+                    r.live.pop_back();
+                    break;
+                }
+            }
+        }
+        for (auto c : caches_) {
+            for (auto chunk : c->chunks)
+                upstream_->deallocate(chunk, chunk_size, chunk_size);
+            delete c;
+        }
+    }
+
+    std::pmr::memory_resource *upstream_resource() const noexcept { return upstream_; }
+
+private:
+    static constexpr std::size_t granule = 16;
+    static constexpr std::size_t classes = max_block / granule;
+    /* chunks are aligned to their size, so that a block finds its chunk's header */
+    static constexpr std::size_t chunk_size = std::size_t(1) << 14;
+    static constexpr unsigned batch = 32;
+
+    struct block {
+        block *next;
+    };
+
+    struct cache {
+        block *free[classes] = {};
+        char *bump[classes] = {};
+        char *bump_end[classes] = {};
+        std::atomic<block *> inbox[classes] = {};
+        /* freed blocks of another thread's, waiting to go back to it */
+        block *out[classes] = {};
+        block *out_tail[classes] = {};
+        cache *out_home[classes] = {};
+        unsigned out_count[classes] = {};
+        std::vector<void *> chunks;
+    };
+
+    struct chunk_header {
+        cache *home;
+    };
+
+    /* the resources alive, so that an exiting thread only hands its caches to those. leaked, as
+     * threads may exit after static destruction
+     */
+    struct live_resources {
+        struct entry {
+            std::uint64_t id;
+            thread_caching_resource *resource;
+        };
+        std::mutex mutex;
+        std::vector<entry> live;
+    };
+
+    static live_resources &registry() {
+        static auto r = new live_resources();
+        return *r;
+    }
+
+    /* a thread's caches, one per resource it used, orphaned when the thread exits */
+    struct thread_caches {
+        struct entry {
+            std::uint64_t id;
+            cache *c;
+        };
+        entry last = {0, nullptr};
+        std::vector<entry> all;
+
+        ~thread_caches() {
+            exiting() = true;
+            auto &r = registry();
+            auto lock = std::lock_guard<std::mutex>(r.mutex);
+            for (auto &e : all)
+                for (auto &l : r.live)
+                    if (l.id == e.id)
+                        l.resource->orphan(e.c);
+        }
+    };
+
+    /* set once a thread's caches are gone, for whatever it frees in its last destructors */
+    static bool &exiting() {
+        thread_local bool exited = false;
+        return exited;
+    }
+
+    static std::uint64_t next_id() {
+        static std::atomic<std::uint64_t> ids{0};
+        return ++ids;
+    }
+
+    static bool pooled(std::size_t bytes, std::size_t alignment) {
+        return bytes <= max_block and alignment <= granule;
+    }
+
+    static std::size_t class_of(std::size_t bytes) {
+        return bytes == 0 ? 0 : (bytes - 1) / granule;
+    }
+
+    /* this thread's cache, or null once the thread is exiting. resources are told apart by an id
+     * rather than their address, which a later one may reuse
+     */
+    cache *local() {
+        if (exiting())
+            return nullptr;
+        thread_local thread_caches mine;
+        if (mine.last.id == id_)
+            return mine.last.c;
+        for (auto &e : mine.all) {
+            if (e.id == id_) {
+                mine.last = e;
+                return e.c;
+            }
+        }
+        cache *c;
+        {
+            auto lock = std::lock_guard<std::mutex>(mutex_);
+            c = adopt();
+        }
+        mine.all.push_back({id_, c});
+        mine.last = mine.all.back();
+        return c;
+    }
+
+    /* an orphaned cache, or a new one. the caller holds mutex_ */
+    cache *adopt() {
+        if (!orphans_.empty()) {
+            auto c = orphans_.back();
+            orphans_.pop_back();
+            return c;
+        }
+        caches_.push_back(new cache());
+        return caches_.back();
+    }
+
+    void orphan(cache *c) {
+        for (std::size_t k = 0; k != classes; ++k)
+            flush(*c, k);
+        auto lock = std::lock_guard<std::mutex>(mutex_);
+        orphans_.push_back(c);
+    }
+
+    static void push(cache &home, std::size_t k, block *first, block *last) {
+        auto &inbox = home.inbox[k];
+        auto head = inbox.load(std::memory_order_relaxed);
+        do {
+            last->next = head;
+        } while (!inbox.compare_exchange_weak(head, first, std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
+
+    void flush(cache &c, std::size_t k) {
+        if (!c.out[k])
+            return;
+        push(*c.out_home[k], k, c.out[k], c.out_tail[k]);
+        c.out[k] = nullptr;
+        c.out_count[k] = 0;
+    }
+
+    void *take(cache &c, std::size_t k) {
+        if (!c.free[k])
+            c.free[k] = c.inbox[k].exchange(nullptr, std::memory_order_acquire);
+        if (auto b = c.free[k]) {
+            c.free[k] = b->next;
+            return b;
+        }
+        auto size = (k + 1) * granule;
+        if (c.bump[k] == c.bump_end[k]) {
+            auto chunk = static_cast<char *>(upstream_->allocate(chunk_size, chunk_size));
+            c.chunks.push_back(chunk);
+            new (chunk) chunk_header{&c};
+            c.bump[k] = chunk + granule;
+            c.bump_end[k] = c.bump[k] + (chunk_size - granule) / size * size;
+        }
+        auto p = c.bump[k];
+        c.bump[k] += size;
+        return p;
+    }
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (!pooled(bytes, alignment))
+            return upstream_->allocate(bytes, alignment);
+        auto k = class_of(bytes);
+        if (auto c = local())
+            return take(*c, k);
+        /* an exiting thread borrows an orphan for the one block */
+        auto lock = std::lock_guard<std::mutex>(mutex_);
+        auto c = adopt();
+        auto p = take(*c, k);
+        orphans_.push_back(c);
+        return p;
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        if (!pooled(bytes, alignment))
+            return upstream_->deallocate(p, bytes, alignment);
+        auto k = class_of(bytes);
+        auto home =
+            reinterpret_cast<chunk_header *>(std::uintptr_t(p) & ~std::uintptr_t(chunk_size - 1))
+                ->home;
+        auto b = static_cast<block *>(p);
+        auto c = local();
+        if (!c)
+            return push(*home, k, b, b);
+        if (home == c) {
+            b->next = c->free[k];
+            c->free[k] = b;
+            return;
+        }
+        if (c->out_home[k] != home)
+            flush(*c, k);
+        if (!c->out[k])
+            c->out_tail[k] = b;
+        b->next = c->out[k];
+        c->out[k] = b;
+        c->out_home[k] = home;
+        if (++c->out_count[k] == batch)
+            flush(*c, k);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource *upstream_;
+    const std::uint64_t id_ = next_id();
+    std::mutex mutex_;
+    std::vector<cache *> caches_;
+    std::vector<cache *> orphans_;
+};
+
+/* the resource pools allocate their tasks from, unless they are given another. it is never
+ * destroyed, so futures in globals can still free into it at exit
+ */
+inline std::pmr::memory_resource *task_resource() {
+    static auto resource = new thread_caching_resource();
+    return resource;
+}
+
+namespace detail {
+/* a type erased callable, in a node allocated from a memory resource */
+template <typename T>
+class task_node {
+public:
+    task_node() noexcept = default;
+
+    template <typename F>
+    task_node(F &&f, std::pmr::memory_resource *resource) {
+        using node_t = node<std::decay_t<F>>;
+        auto alloc = std::pmr::polymorphic_allocator<node_t>(resource);
+        auto p = alloc.allocate(1);
+        try {
+            node_ = new (p) node_t(std::forward<F>(f), resource);
+        } catch (...) {
+            alloc.deallocate(p, 1);
+            throw;
+        }
+    }
+
+    task_node(task_node &&rhs) noexcept : node_(std::exchange(rhs.node_, nullptr)) {}
+    task_node &operator=(task_node &&rhs) noexcept {
+        std::swap(node_, rhs.node_);
+        return *this;
+    }
+    ~task_node() {
+        if (node_)
+            node_->destroy();
+    }
+
+    explicit operator bool() const noexcept { return node_; }
+    T operator()() { return node_->run(); }
+
+private:
+    struct base {
+        std::pmr::memory_resource *resource;
+
+        explicit base(std::pmr::memory_resource *resource) : resource(resource) {}
+        virtual T run() = 0;
+        virtual void destroy() noexcept = 0;
+
+    protected:
+        ~base() = default;
+    };
+
+    template <typename F>
+    struct node final : base {
+        F f;
+
+        template <typename G>
+        node(G &&g, std::pmr::memory_resource *resource)
+          : base(resource), f(std::forward<G>(g)) {}
+
+        T run() override { return f(); }
+        void destroy() noexcept override {
+            auto alloc = std::pmr::polymorphic_allocator<node>(this->resource);
+            this->~node();
+            alloc.deallocate(this, 1);
+        }
+    };
+
+    base *node_ = nullptr;
+};
+
+/* a task node running f on args, which are copied */
+template <typename T, typename F, typename... Args>
+task_node<T> make_task(std::pmr::memory_resource *resource, F &&f, Args &&...args) {
+    return task_node<T>(
+        [f = decay_copy(std::forward<F>(f)),
+         args = std::make_tuple(decay_copy(std::forward<Args>(args))...)]() mutable -> T {
+            if constexpr (std::is_void_v<T>)
+                std::apply(std::move(f), std::move(args));
+            else
+                return T(std::apply(std::move(f), std::move(args)));
+        },
+        resource);
+}
+} // namespace detail
+
 template <typename T>
 class mustached_future {
 private:
     std::future<T> exec_ = {};
-    std::promise<T> promise_ = {};
+    detail::task_node<T> task_ = {};
+    /* empty in the thunks workers pop into, where a promise would allocate for nothing */
+    std::optional<std::promise<T>> promise_ = {};
+
+    T execute() { return task_ ? task_() : exec_.get(); }
 
 public:
     mustached_future() noexcept = default;
-    explicit mustached_future(std::future<T> &&f) : exec_(std::move(f)) {}
+    explicit mustached_future(std::future<T> &&f) : exec_(std::move(f)), promise_(std::in_place) {}
+    /* the promise's shared state comes from resource */
+    mustached_future(std::future<T> &&f, std::pmr::memory_resource *resource)
+      : exec_(std::move(f)),
+        promise_(std::in_place, std::allocator_arg,
+                 std::pmr::polymorphic_allocator<char>(resource)) {}
+    /* a task in a node, whose promise comes from the same resource */
+    mustached_future(detail::task_node<T> &&task, std::pmr::memory_resource *resource)
+      : task_(std::move(task)),
+        promise_(std::in_place, std::allocator_arg,
+                 std::pmr::polymorphic_allocator<char>(resource)) {}
 
     mustached_future(const mustached_future &) = delete;
     mustached_future &operator=(const mustached_future &) = delete;
@@ -62,28 +457,29 @@ public:
     mustached_future(mustached_future &&rhs) noexcept = default;
     mustached_future &operator=(mustached_future &&rhs) noexcept = default;
 
-    bool valid() const noexcept { return exec_.valid(); }
+    bool valid() const noexcept { return exec_.valid() or bool(task_); }
     void swap(mustached_future &other) noexcept {
         using std::swap;
         swap(exec_, other.exec_);
+        swap(task_, other.task_);
         swap(promise_, other.promise_);
     }
 
     /* getting the result */
-    std::future<T> get_future() { return promise_.get_future(); }
+    std::future<T> get_future() { return promise_->get_future(); }
 
     /* execution */
     void operator()() {
         try {
             if constexpr (std::is_void_v<T>) {
-                exec_.get();
-                promise_.set_value();
+                execute();
+                promise_->set_value();
             } else {
-                promise_.set_value(exec_.get());
+                promise_->set_value(execute());
             }
         } catch (...) {
             try {
-                promise_.set_exception(std::current_exception());
+                promise_->set_exception(std::current_exception());
             } catch (...) {} // set_exception() may throw too
         }
     }
@@ -96,12 +492,20 @@ public:
     using t_thunk = mustached_future<T>;
 
 private:
-    std::deque<t_thunk> q_;
+    std::pmr::memory_resource *resource_;
+    std::pmr::deque<t_thunk> q_;
     bool done_ = false;
     std::mutex mutex_;
     std::condition_variable ready_;
 
 public:
+    /* the queue's nodes and the completion states of its tasks come from resource, which
+     * pushing and running threads use at once, so it has to be thread safe. the pools below
+     * take a resource in the same way and hand it to their queues
+     */
+    explicit notification_queue(std::pmr::memory_resource *resource = task_resource())
+      : resource_(resource), q_(resource) {}
+
     void finish() {
         {
             auto lock = t_lock{mutex_};
@@ -140,7 +544,7 @@ public:
             if (!lock)
                 return std::nullopt;
 
-            return q_.emplace_back(std::move(f)).get_future();
+            return q_.emplace_back(std::move(f), resource_).get_future();
         }();
         ready_.notify_one();
         return fut;
@@ -150,7 +554,29 @@ public:
     std::future<T> push(std::future<U> &&f) {
         auto fut = [&] {
             auto lock = t_lock{mutex_};
-            return q_.emplace_back(std::move(f)).get_future();
+            return q_.emplace_back(std::move(f), resource_).get_future();
+        }();
+        ready_.notify_one();
+        return fut;
+    }
+
+    /* a task node is only moved from when it is pushed */
+    std::optional<std::future<T>> try_push(detail::task_node<T> &&task) {
+        auto fut = [&]() -> std::optional<std::future<T>> {
+            auto lock = t_lock(mutex_, std::try_to_lock);
+            if (!lock)
+                return std::nullopt;
+
+            return q_.emplace_back(std::move(task), resource_).get_future();
+        }();
+        ready_.notify_one();
+        return fut;
+    }
+
+    std::future<T> push(detail::task_node<T> &&task) {
+        auto fut = [&] {
+            auto lock = t_lock{mutex_};
+            return q_.emplace_back(std::move(task), resource_).get_future();
         }();
         ready_.notify_one();
         return fut;
@@ -164,6 +590,7 @@ private:
     using t_thunk = typename notification_queue<T>::t_thunk;
 
     const unsigned n_workers_ = std::thread::hardware_concurrency();
+    std::pmr::memory_resource *resource_;
     std::vector<std::thread> workers_;
     notification_queue<T> q_;
 
@@ -180,8 +607,11 @@ private:
 public:
     using future_t = std::future<T>;
 
-    single_queue(unsigned n_workers = std::thread::hardware_concurrency())
-      : n_workers_(n_workers) {
+    unsigned n_workers() const noexcept { return n_workers_; }
+
+    single_queue(unsigned n_workers = std::thread::hardware_concurrency(),
+                 std::pmr::memory_resource *resource = task_resource())
+      : n_workers_(n_workers), resource_(resource), q_(resource) {
         for (auto n = 0u; n != n_workers_; ++n) {
             workers_.emplace_back([&] { run(); });
         }
@@ -195,8 +625,8 @@ public:
 
     template <typename F, typename... Args>
     future_t async(F &&f, Args &&...args) {
-        return q_.push(std::async(std::launch::deferred, std::forward<F>(f),
-                                  std::forward<Args>(args)...));
+        return q_.push(
+            detail::make_task<T>(resource_, std::forward<F>(f), std::forward<Args>(args)...));
     }
 };
 
@@ -207,8 +637,9 @@ private:
     using t_thunk = typename notification_queue<T>::t_thunk;
 
     const unsigned n_workers_ = std::thread::hardware_concurrency();
+    std::pmr::memory_resource *resource_;
     std::vector<std::thread> workers_;
-    std::vector<notification_queue<T>> q_{n_workers_};
+    std::deque<notification_queue<T>> q_;
     std::atomic<unsigned> index_{0};
 
     void run(unsigned i) {
@@ -225,8 +656,13 @@ private:
 public:
     using future_t = std::future<T>;
 
-    multi_queue(unsigned n_workers = std::thread::hardware_concurrency())
-      : n_workers_(n_workers) {
+    unsigned n_workers() const noexcept { return n_workers_; }
+
+    multi_queue(unsigned n_workers = std::thread::hardware_concurrency(),
+                std::pmr::memory_resource *resource = task_resource())
+      : n_workers_(n_workers), resource_(resource) {
+        for (auto n = 0u; n != n_workers_; ++n)
+            q_.emplace_back(resource);
         for (auto n = 0u; n != n_workers_; ++n) {
             workers_.emplace_back([&, n] { run(n); });
         }
@@ -242,8 +678,8 @@ public:
     template <typename F, typename... Args>
     future_t async(F &&f, Args &&...args) {
         auto i = index_++;
-        return q_[i % n_workers_].push(std::async(std::launch::deferred, std::forward<F>(f),
-                                                  std::forward<Args>(args)...));
+        return q_[i % n_workers_].push(
+            detail::make_task<T>(resource_, std::forward<F>(f), std::forward<Args>(args)...));
     }
 };
 
@@ -255,8 +691,9 @@ private:
 
     unsigned const n_workers_ = std::thread::hardware_concurrency();
     static constexpr auto k = 2;
+    std::pmr::memory_resource *resource_;
     std::vector<std::thread> workers_;
-    std::vector<notification_queue<T>> q_{n_workers_};
+    std::deque<notification_queue<T>> q_;
     std::atomic<unsigned> index_{0};
 
     void run(unsigned i) {
@@ -276,8 +713,13 @@ private:
 public:
     using future_t = std::future<T>;
 
-    task_stealing_queue(unsigned n_workers = std::thread::hardware_concurrency())
-      : n_workers_(n_workers) {
+    unsigned n_workers() const noexcept { return n_workers_; }
+
+    task_stealing_queue(unsigned n_workers = std::thread::hardware_concurrency(),
+                        std::pmr::memory_resource *resource = task_resource())
+      : n_workers_(n_workers), resource_(resource) {
+        for (auto n = 0u; n != n_workers_; ++n)
+            q_.emplace_back(resource);
         for (auto n = 0u; n != n_workers_; ++n) {
             workers_.emplace_back([&, n] { run(n); });
         }
@@ -297,25 +739,7 @@ public:
 
     template <typename F, typename... Args>
     future_t async(F &&f, Args &&...args) {
-
-        auto g = [&]() {
-            if constexpr (std::is_void_v<T>) {
-                return std::async(
-                    std::launch::deferred,
-                    [f = decay_copy(f),
-                     args = std::make_tuple(decay_copy(std::forward<Args>(args))...)]() -> void {
-                        std::apply(std::move(f), args);
-                        return;
-                    });
-            } else {
-                return std::async(
-                    std::launch::deferred,
-                    [f = decay_copy(f)](Args &&...args) -> T {
-                        return (T)std::invoke(std::move(f), std::forward<Args>(args)...);
-                    },
-                    std::forward<Args>(args)...);
-            }
-        }();
+        auto g = detail::make_task<T>(resource_, std::forward<F>(f), std::forward<Args>(args)...);
         auto i = index_++;
         for (auto n = 0u; n != n_workers_ * k; ++n) {
             if (auto p = q_[(i + n) % n_workers_].try_push(std::move(g)); p)
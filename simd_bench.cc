@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+
+#include "bench.h"
+#include "include/algorithm.h"
+#include "include/simd.h"
+
+/* times the std:: algorithms against drift's simd kernels, on every instruction set the cpu
+ * supports
+ */
+
+volatile std::size_t sink;
+
+template <typename T>
+void bench(const std::string &name, std::size_t n) {
+    using drift::simd::isa;
+
+    auto rng = std::mt19937(42);
+    auto v = std::vector<T>(n);
+    for (auto &x : v)
+        x = T(rng() % 100);
+    auto w = v;
+    /* a value that isn't there, so find scans everything */
+    auto missing = T(101);
+
+    auto line = [&](const std::string &algo, auto std_version, auto drift_version) {
+        std::cout << name << " " << algo << ":  std " << best_of(5, std_version) << " ms";
+        for (auto i : {isa::scalar, isa::sse2, isa::avx2, isa::avx512}) {
+            if (drift::simd::supported_isa() < i)
+                break;
+            drift::simd::limit_isa(i);
+            static const char *names[] = {"scalar", "sse2", "avx2", "avx512"};
+            std::cout << ",  " << names[int(i)] << " " << best_of(5, drift_version) << " ms";
+        }
+        drift::simd::limit_isa(isa::avx512);
+        std::cout << "\n";
+    };
+
+    line(
+        "count", [&] { sink = std::size_t(std::count(v.begin(), v.end(), T(7))); },
+        [&] { sink = std::size_t(drift::count(v, T(7))); });
+    line(
+        "find", [&] { sink = std::size_t(std::find(v.begin(), v.end(), missing) - v.begin()); },
+        [&] { sink = std::size_t(drift::find(v, missing) - v.begin()); });
+    line(
+        "minmax_element",
+        [&] { sink = std::size_t(std::minmax_element(v.begin(), v.end()).first - v.begin()); },
+        [&] { sink = std::size_t(drift::minmax_element(v).first - v.begin()); });
+    if constexpr (std::is_integral_v<T>) {
+        line(
+            "accumulate", [&] { sink = std::size_t(std::accumulate(v.begin(), v.end(), T(0))); },
+            [&] { sink = std::size_t(drift::accumulate(v, T(0))); });
+        line(
+            "inner_product",
+            [&] { sink = std::size_t(std::inner_product(v.begin(), v.end(), w.begin(), T(0))); },
+            [&] { sink = std::size_t(drift::inner_product(v, w, T(0))); });
+    }
+}
+
+int main(int argc, char **argv) {
+    auto n = std::size_t(argc > 1 ? std::stoull(argv[1]) : 1 << 24);
+
+    bench<std::uint8_t>("uint8", n);
+    bench<std::int16_t>("int16", n);
+    bench<std::int32_t>("int32", n);
+    bench<std::int64_t>("int64", n);
+    bench<float>("float", n);
+    bench<double>("double", n);
+}
@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+#include "bench.h"
+#include "include/algorithm.h"
+#include "include/drift.h"
+#include "include/tasks.h"
+
+/* times drift::sort against drift::radix_sort, serial and on a task_stealing_queue, and then
+ * drift::parallel_sort and parallel_stable_sort on pools of 1 to 64 workers
+ */
+
+template <typename T, typename Gen>
+void bench(const std::string &name, std::size_t n, Gen gen, drift::task_stealing_queue<> &pool) {
+    auto input = std::vector<T>(n);
+    for (auto &x : input)
+        x = T(gen());
+    auto v = input;
+    auto reset = [&] { v = input; };
+
+    auto run = [&](auto sort) {
+        return best_of(5, [&] {
+            reset();
+            sort();
+        });
+    };
+    auto copy = best_of(5, reset);
+
+    auto t_sort = run([&] { drift::sort(v); }) - copy;
+    auto t_radix = run([&] { drift::radix_sort(v); }) - copy;
+    auto t_pool = run([&] { drift::radix_sort(pool, v); }) - copy;
+
+    std::cout << name << ", n = " << n << ":  sort " << t_sort << " ms,  radix_sort " << t_radix
+              << " ms (" << t_sort / t_radix << "x),  radix_sort on " << pool.n_workers()
+              << " workers " << t_pool << " ms (" << t_sort / t_pool << "x)\n";
+}
+
+void scaling(std::size_t n) {
+    auto rng = std::mt19937_64(7);
+    auto input = std::vector<double>(n);
+    for (auto &x : input)
+        x = double(rng());
+    auto v = input;
+    auto run = [&](auto sort) {
+        return best_of(3, [&] {
+            v = input;
+            sort();
+        });
+    };
+    auto copy = best_of(3, [&] { v = input; });
+    auto t_sort = run([&] { drift::sort(v); }) - copy;
+    auto t_stable = run([&] { drift::stable_sort(v); }) - copy;
+
+    std::cout << "double, n = " << n << ":  sort " << t_sort << " ms,  stable_sort " << t_stable
+              << " ms\n";
+    for (unsigned workers = 1; workers <= 64; workers *= 2) {
+        auto pool = drift::task_stealing_queue<>(workers);
+        auto t_par = run([&] { drift::parallel_sort(pool, v); }) - copy;
+        auto t_par_stable = run([&] { drift::parallel_stable_sort(pool, v); }) - copy;
+        std::cout << "  " << workers << " workers:  parallel_sort " << t_par << " ms ("
+                  << t_sort / t_par << "x),  parallel_stable_sort " << t_par_stable << " ms ("
+                  << t_stable / t_par_stable << "x)\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    auto n = std::size_t(argc > 1 ? std::stoull(argv[1]) : 1 << 24);
+    auto pool = drift::task_stealing_queue<>();
+    auto rng = std::mt19937_64(42);
+    auto real = std::normal_distribution<double>(0., 1e6);
+
+    bench<std::uint32_t>("uint32", n, rng, pool);
+    bench<std::int32_t>("int32", n, rng, pool);
+    bench<std::uint64_t>("uint64", n, rng, pool);
+    bench<std::int64_t>("int64", n, rng, pool);
+    bench<float>("float", n, [&] { return real(rng); }, pool);
+    bench<double>("double", n, [&] { return real(rng); }, pool);
+    scaling(n);
+}
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+
+#include "bench.h"
+#include "include/algorithm.h"
+#include "include/drift.h"
+#include "include/tasks.h"
+
+/* times drift::summarize over four columns against one std:: pass per statistic and column */
+
+volatile double sink;
+
+/* sum, min, max and variance the usual way: four passes */
+template <typename T>
+double separate_passes(const std::vector<T> &v) {
+    auto sum = std::accumulate(v.begin(), v.end(), 0.);
+    auto [lo, hi] = std::minmax_element(v.begin(), v.end());
+    auto mean = sum / double(v.size());
+    auto m2 = std::accumulate(v.begin(), v.end(), 0., [mean](double acc, T x) {
+        return acc + (double(x) - mean) * (double(x) - mean);
+    });
+    return sum + double(*lo) + double(*hi) + m2;
+}
+
+int main(int argc, char **argv) {
+    auto n = std::size_t(argc > 1 ? std::stoull(argv[1]) : 1 << 24);
+    auto rng = std::mt19937_64(42);
+    auto real = std::normal_distribution<double>(0., 1e3);
+
+    auto a = std::vector<double>(n), b = std::vector<double>(n);
+    auto c = std::vector<std::int32_t>(n);
+    auto d = std::vector<float>(n);
+    for (std::size_t i = 0; i != n; ++i) {
+        a[i] = real(rng);
+        b[i] = real(rng);
+        c[i] = std::int32_t(rng());
+        d[i] = float(real(rng));
+    }
+
+    auto t_std = best_of(5, [&] {
+        sink = separate_passes(a) + separate_passes(b) + separate_passes(c) + separate_passes(d);
+    });
+    auto t_fused = best_of(5, [&] {
+        auto [sa, sb, sc, sd] = drift::summarize(drift::zip(a, b, c, d));
+        sink = sa.m2 + sb.m2 + sc.m2 + sd.m2;
+    });
+    auto pool = drift::task_stealing_queue<>();
+    auto t_pool = best_of(5, [&] {
+        auto [sa, sb, sc, sd] = drift::summarize(pool, drift::zip(a, b, c, d));
+        sink = sa.m2 + sb.m2 + sc.m2 + sd.m2;
+    });
+
+    std::cout << "4 columns, n = " << n << ":  separate passes " << t_std << " ms,  summarize "
+              << t_fused << " ms (" << t_std / t_fused << "x),  summarize on " << pool.n_workers()
+              << " workers " << t_pool << " ms (" << t_std / t_pool << "x)\n";
+}
@@ -0,0 +1,68 @@
+#include <future>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+#define DRIFT_COUNT_ALLOCATIONS
+#include "bench.h"
+#include "include/tasks.h"
+
+/* times a million empty tasks on drift's pools, with the pools' default resource and with new
+ * and delete, and measures the time spent allocating and freeing for them and how many
+ * allocations reach the global allocator
+ */
+
+template <typename Pool>
+void bench(const std::string &name, Pool &pool, std::size_t n) {
+    auto futures = std::vector<std::future<void>>(n);
+    auto run = [&] {
+        for (auto &f : futures)
+            f = pool.async([] {});
+        for (auto &f : futures)
+            f.get();
+        for (auto &f : futures)
+            f = {};
+    };
+    run();
+    auto before = allocations.load();
+    auto ms = best_of(3, run);
+    auto per_task = double(allocations.load() - before) / (3. * double(n));
+    std::cout << name << ":  " << ms * 1e6 / double(n) << " ns and " << per_task
+              << " global allocations per task\n";
+}
+
+/* the allocations of a task alone: one thread allocates a task node, a shared state and a
+ * result, and another frees them
+ */
+void allocator_time(const std::string &name, std::pmr::memory_resource *resource,
+                    std::size_t n) {
+    constexpr std::size_t sizes[] = {32, 48, 16};
+    auto blocks = std::vector<void *>(3 * n);
+    auto ms = best_of(3, [&] {
+        for (std::size_t i = 0; i != blocks.size(); ++i)
+            blocks[i] = resource->allocate(sizes[i % 3]);
+        std::thread([&] {
+            for (std::size_t i = 0; i != blocks.size(); ++i)
+                resource->deallocate(blocks[i], sizes[i % 3]);
+        }).join();
+    });
+    std::cout << name << ":  " << ms * 1e6 / double(n) << " ns per task\n";
+}
+
+int main(int argc, char **argv) {
+    auto n = std::size_t(argc > 1 ? std::stoull(argv[1]) : 1000000);
+
+    allocator_time("allocating on new and delete", std::pmr::new_delete_resource(), n);
+    allocator_time("allocating on the task resource", drift::task_resource(), n);
+    for (unsigned workers : {1u, 4u}) {
+        auto pool = drift::task_stealing_queue<>(workers);
+        bench("task_stealing_queue, " + std::to_string(workers) + " workers", pool, n);
+        auto plain = drift::task_stealing_queue<>(workers, std::pmr::new_delete_resource());
+        bench("  on new and delete", plain, n);
+        auto multi = drift::multi_queue<>(workers);
+        bench("multi_queue, " + std::to_string(workers) + " workers", multi, n);
+    }
+}
@@ -1,12 +1,19 @@
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <forward_list>
 #include <functional>
+#include <limits>
+#include <memory_resource>
 #include <numeric>
+#include <random>
 #include <string>
 #include <vector>
 
 
 #include "../include/drift.h"
 #include "../include/algorithm.h"
+#include "../include/tasks.h"
 #include "../../catch2/catch.hpp"
 
 TEST_CASE("all_of, any_of, none_of", "[algo]") {
@@ -286,4 +293,752 @@ TEST_CASE("inner_product", "[algo]") {
         int r2 = drift::inner_product(a, b, 0, std::plus<>(), std::equal_to<>());
         REQUIRE(r2 == 2);
     }
-}
\ No newline at end of file
+}
+
+/* parallel algorithms */
+TEST_CASE("parallel_for_each", "[algo]") {
+    drift::task_stealing_queue<> pool(4);
+
+    std::vector<int> a(1000);
+    std::vector<int> b(1000);
+    std::iota(a.begin(), a.end(), 0);
+
+    SECTION("indexed zip, global indices") {
+        drift::parallel_for_each(
+            pool, drift::indexed(drift::zip(a, b)),
+            [](auto &&iab) {
+                auto [i, ab] = iab;
+                auto [x, y] = ab;
+                y = x + int(i);
+            },
+            16);
+
+        for (int i = 0; i != 1000; ++i)
+            REQUIRE(b[i] == 2 * i);
+    }
+
+    SECTION("plain vector") {
+        std::atomic<long> sum{0};
+        drift::parallel_for_each(pool, a, [&](int x) { sum += x; });
+        REQUIRE(sum == 999 * 1000 / 2);
+    }
+}
+
+TEST_CASE("sort_zipped", "[algo]") {
+    std::vector<int> keys{5, 3, 9, 3, 1, 5};
+    std::vector<std::string> names{"e", "c1", "i", "c2", "a", "e2"};
+    std::vector<double> weights{5., 3., 9., 3.5, 1., 5.5};
+
+    SECTION("payloads follow their keys") {
+        drift::sort_zipped(keys, names, weights);
+        REQUIRE(keys == std::vector<int>{1, 3, 3, 5, 5, 9});
+        REQUIRE(std::is_sorted(keys.begin(), keys.end()));
+        for (auto [k, n, w] : drift::zip(keys, names, weights))
+            REQUIRE(int(w) == k);
+    }
+
+    SECTION("stable") {
+        drift::stable_sort_zipped(keys, names, weights);
+        REQUIRE(keys == std::vector<int>{1, 3, 3, 5, 5, 9});
+        REQUIRE(names == std::vector<std::string>{"a", "c1", "c2", "e", "e2", "i"});
+        REQUIRE(weights == std::vector<double>{1., 3., 3.5, 5., 5.5, 9.});
+    }
+
+    SECTION("keys only, and empty ranges") {
+        drift::sort_zipped(keys);
+        REQUIRE(keys == std::vector<int>{1, 3, 3, 5, 5, 9});
+
+        std::vector<int> none;
+        drift::stable_sort_zipped(none, none);
+        REQUIRE(none.empty());
+    }
+}
+
+TEST_CASE("radix_sort", "[algo]") {
+    auto lcg = [x = std::uint64_t(12345)]() mutable {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        return x >> 16;
+    };
+
+    SECTION("unsigned and signed integers") {
+        std::vector<std::uint32_t> u(5000);
+        std::vector<std::int64_t> s(5000);
+        for (auto [a, b] : drift::zip(u, s)) {
+            a = std::uint32_t(lcg());
+            b = std::int64_t(lcg()) - (std::int64_t(1) << 47);
+        }
+        s[0] = std::numeric_limits<std::int64_t>::min();
+        s[1] = std::numeric_limits<std::int64_t>::max();
+
+        auto u_sorted = u;
+        auto s_sorted = s;
+        std::sort(u_sorted.begin(), u_sorted.end());
+        std::sort(s_sorted.begin(), s_sorted.end());
+        drift::radix_sort(u);
+        drift::radix_sort(s);
+        REQUIRE(u == u_sorted);
+        REQUIRE(s == s_sorted);
+    }
+
+    SECTION("small keys and uniform digits") {
+        std::vector<short> v{3, -1, 0, -32768, 32767, 3, -1};
+        drift::radix_sort(v);
+        REQUIRE(v == std::vector<short>{-32768, -1, -1, 0, 3, 3, 32767});
+
+        std::vector<std::uint64_t> w{0x700, 0x100, 0x500, 0x100};
+        drift::radix_sort(w);
+        REQUIRE(w == std::vector<std::uint64_t>{0x100, 0x100, 0x500, 0x700});
+    }
+
+    SECTION("floats, negative ones included") {
+        auto inf = std::numeric_limits<double>::infinity();
+        std::vector<double> v{2.5, -0.5, inf, -1e300, 0., -inf, 1e-300, -2.5, 7.};
+        auto sorted = v;
+        std::sort(sorted.begin(), sorted.end());
+        drift::radix_sort(v);
+        REQUIRE(v == sorted);
+
+        std::vector<float> f{1.f, -3.f, 0.25f, -0.25f, 2.f};
+        drift::radix_sort(f);
+        REQUIRE(f == std::vector<float>{-3.f, -0.25f, 0.25f, 1.f, 2.f});
+    }
+
+    SECTION("by key, stable") {
+        std::vector<int> keys{5, 3, 9, 3, 1, 5};
+        std::vector<std::string> names{"e", "c1", "i", "c2", "a", "e2"};
+        drift::radix_sort_by_key(keys, names);
+        REQUIRE(keys == std::vector<int>{1, 3, 3, 5, 5, 9});
+        REQUIRE(names == std::vector<std::string>{"a", "c1", "c2", "e", "e2", "i"});
+    }
+
+    SECTION("on a pool") {
+        drift::task_stealing_queue<> pool(4);
+
+        std::vector<std::int32_t> keys(1 << 19);
+        for (auto &k : keys)
+            k = std::int32_t(lcg());
+        std::vector<std::size_t> rows(keys.size());
+        std::iota(rows.begin(), rows.end(), 0);
+
+        auto sorted = keys;
+        std::stable_sort(sorted.begin(), sorted.end());
+        auto original = keys;
+
+        drift::radix_sort_by_key(pool, keys, rows);
+        REQUIRE(keys == sorted);
+        auto follows = true;
+        for (std::size_t i = 0; i != rows.size(); ++i) {
+            follows = follows and original[rows[i]] == keys[i];
+            if (i and keys[i - 1] == keys[i])
+                follows = follows and rows[i - 1] < rows[i];
+        }
+        REQUIRE(follows);
+
+        std::vector<float> f(1 << 18);
+        for (auto &x : f)
+            x = float(std::int32_t(lcg())) / 7.f;
+        auto f_sorted = f;
+        std::sort(f_sorted.begin(), f_sorted.end());
+        drift::radix_sort(pool, f);
+        REQUIRE(f == f_sorted);
+    }
+}
+
+TEST_CASE("reduce and scans", "[algo]") {
+    std::vector<int> v{3, 1, 4, 1, 5, 9, 2, 6};
+    std::vector<int> out(v.size());
+
+    SECTION("reduce") {
+        REQUIRE(drift::reduce(v) == 31);
+        REQUIRE(drift::reduce(v, 10) == 41);
+        REQUIRE(drift::reduce(v, 1, std::multiplies<>()) == 6480);
+        REQUIRE(drift::reduce(std::vector<int>{}, 7) == 7);
+    }
+
+    SECTION("scans") {
+        REQUIRE(drift::inclusive_scan(v, out) == out.end());
+        REQUIRE(out == std::vector<int>{3, 4, 8, 9, 14, 23, 25, 31});
+
+        drift::inclusive_scan(v, out, [](int a, int b) { return std::max(a, b); });
+        REQUIRE(out == std::vector<int>{3, 3, 4, 4, 5, 9, 9, 9});
+
+        drift::inclusive_scan(v, out, std::plus<>(), 100);
+        REQUIRE(out.front() == 103);
+        REQUIRE(out.back() == 131);
+
+        drift::exclusive_scan(v, out, 0);
+        REQUIRE(out == std::vector<int>{0, 3, 4, 8, 9, 14, 23, 25});
+
+        /* in place */
+        drift::exclusive_scan(v, v, 1, std::multiplies<>());
+        REQUIRE(v == std::vector<int>{1, 3, 3, 12, 12, 60, 540, 1080});
+    }
+
+    SECTION("transforms") {
+        auto square = [](int x) { return x * x; };
+        REQUIRE(drift::transform_reduce(v, v, 0) == 173);
+        REQUIRE(drift::transform_reduce(v, 0, std::plus<>(), square) == 173);
+        REQUIRE(drift::transform_reduce(v, v, 0, std::plus<>(), std::minus<>()) == 0);
+
+        drift::transform_inclusive_scan(v, out, std::plus<>(), square);
+        REQUIRE(out.back() == 173);
+        drift::transform_inclusive_scan(v, out, std::plus<>(), square, 1);
+        REQUIRE(out.front() == 10);
+        drift::transform_exclusive_scan(v, out, 0, std::plus<>(), square);
+        REQUIRE(out == std::vector<int>{0, 9, 10, 26, 27, 52, 133, 137});
+
+        /* the sum has the transform's type, not the input's */
+        std::vector<double> halves(v.size());
+        drift::transform_inclusive_scan(v, halves, std::plus<>(), [](int x) { return x * 0.5; });
+        REQUIRE(halves == std::vector<double>{1.5, 2, 4, 4.5, 7, 11.5, 12.5, 15.5});
+    }
+
+    SECTION("forward ranges") {
+        std::forward_list<int> l(v.begin(), v.end());
+        REQUIRE(drift::reduce(l) == 31);
+        REQUIRE(drift::reduce(drift::unseq, l) == 31);
+        REQUIRE(drift::transform_reduce(drift::unseq, l, v, 0) == 173);
+    }
+}
+
+TEST_CASE("unsequenced reductions", "[algo]") {
+    std::vector<long> v(1003);
+    std::iota(v.begin(), v.end(), 1);
+
+    for (std::size_t n : {0, 1, 15, 16, 17, 100, 1003}) {
+        auto w = std::vector<long>(v.begin(), v.begin() + n);
+        auto sum = long(n * (n + 1) / 2);
+        REQUIRE(drift::reduce(drift::unseq, w) == sum);
+        REQUIRE(drift::reduce(drift::unseq, w, 5L) == sum + 5);
+        REQUIRE(drift::transform_reduce(drift::unseq, w, w, 0L) ==
+                std::inner_product(w.begin(), w.end(), w.begin(), 0L));
+        REQUIRE(drift::transform_reduce(drift::unseq, w, 0L, std::plus<>(),
+                                        [](long x) { return 2 * x; }) == 2 * sum);
+    }
+
+    SECTION("floats, up to rounding") {
+        std::vector<double> d(10000, 0.1);
+        REQUIRE(drift::reduce(drift::unseq, d) == Approx(1000.));
+        REQUIRE(drift::transform_reduce(drift::unseq, d, d, 0.) == Approx(100.));
+    }
+
+    SECTION("operations other than plus") {
+        REQUIRE(drift::reduce(drift::unseq, v, 0L, [](long a, long b) { return std::max(a, b); }) ==
+                1003);
+    }
+}
+
+TEST_CASE("parallel scans", "[algo]") {
+    drift::task_stealing_queue<> pool(4);
+
+    std::vector<long> v(100000);
+    for (std::size_t i = 0; i != v.size(); ++i)
+        v[i] = long(i % 7) - 3;
+    std::vector<long> expected(v.size()), out(v.size());
+
+    SECTION("inclusive and exclusive") {
+        std::partial_sum(v.begin(), v.end(), expected.begin());
+        REQUIRE(drift::parallel_inclusive_scan(pool, v, out) == out.end());
+        REQUIRE(out == expected);
+
+        drift::parallel_inclusive_scan(pool, v, out, std::plus<>(), 10L);
+        REQUIRE(out.front() == v.front() + 10);
+        REQUIRE(out.back() == expected.back() + 10);
+
+        drift::exclusive_scan(v, expected, 5L);
+        drift::parallel_exclusive_scan(pool, v, out, 5L);
+        REQUIRE(out == expected);
+    }
+
+    SECTION("any associative op, in place") {
+        auto max = [](long a, long b) { return std::max(a, b); };
+        v[70000] = 100;
+        drift::inclusive_scan(v, expected, max);
+        drift::parallel_inclusive_scan(pool, v, v, max);
+        REQUIRE(v == expected);
+        REQUIRE(v[69999] == 3);
+        REQUIRE(v[70000] == 100);
+    }
+
+    SECTION("short ranges") {
+        std::vector<int> none, one{4};
+        REQUIRE(drift::parallel_inclusive_scan(pool, none, none) == none.end());
+        drift::parallel_exclusive_scan(pool, one, one, 1);
+        REQUIRE(one == std::vector<int>{1});
+    }
+
+    SECTION("several columns at once") {
+        std::vector<double> w(v.size(), 0.5);
+        std::vector<double> w_out(v.size());
+
+        drift::parallel_inclusive_scan(pool, drift::zip(v, w), drift::zip(out, w_out),
+                                       drift::elementwise(std::plus<>()));
+        std::partial_sum(v.begin(), v.end(), expected.begin());
+        REQUIRE(out == expected);
+        REQUIRE(w_out.back() == 0.5 * double(w.size()));
+
+        /* a running sum of one column and a running max of the other */
+        drift::parallel_exclusive_scan(
+            pool, drift::zip(v, w), drift::zip(out, w_out), std::tuple<long, double>(0, -1.),
+            drift::elementwise(std::plus<>(), [](double a, double b) { return std::max(a, b); }));
+        REQUIRE(out[1] == v[0]);
+        REQUIRE(w_out[0] == -1.);
+        REQUIRE(w_out[1] == 0.5);
+    }
+}
+
+TEST_CASE("parallel compaction and partitioning", "[algo]") {
+    drift::task_stealing_queue<> pool(4);
+
+    std::vector<int> v(100000);
+    std::iota(v.begin(), v.end(), 0);
+    auto odd = [](int x) { return x % 2 != 0; };
+    auto multiple_of_3 = [](int x) { return x % 3 == 0; };
+
+    SECTION("copy_if") {
+        std::vector<int> out(v.size()), expected;
+        std::copy_if(v.begin(), v.end(), std::back_inserter(expected), multiple_of_3);
+
+        auto last = drift::parallel_copy_if(pool, v, out, multiple_of_3);
+        REQUIRE(last - out.begin() == std::ptrdiff_t(expected.size()));
+        out.erase(last, out.end());
+        REQUIRE(out == expected);
+    }
+
+    SECTION("partition_copy") {
+        std::vector<int> odds(v.size()), evens(v.size());
+        auto [t, f] = drift::parallel_partition_copy(pool, v, odds, evens, odd);
+        REQUIRE(t - odds.begin() == 50000);
+        REQUIRE(f - evens.begin() == 50000);
+        REQUIRE(odds[0] == 1);
+        REQUIRE(odds[49999] == 99999);
+        REQUIRE(evens[49999] == 99998);
+    }
+
+    SECTION("partition is stable") {
+        auto mid = drift::parallel_partition(pool, v, multiple_of_3);
+        REQUIRE(mid - v.begin() == 33334);
+        REQUIRE(std::all_of(v.begin(), mid, multiple_of_3));
+        REQUIRE(std::none_of(mid, v.end(), multiple_of_3));
+        REQUIRE(std::is_sorted(v.begin(), mid));
+        REQUIRE(std::is_sorted(mid, v.end()));
+    }
+
+    SECTION("remove_if") {
+        std::vector<std::string> s(v.size());
+        for (std::size_t i = 0; i != s.size(); ++i)
+            s[i] = std::to_string(i);
+        auto last = drift::parallel_remove_if(pool, s, [](const std::string &x) {
+            return x.back() != '7';
+        });
+        REQUIRE(last - s.begin() == 10000);
+        REQUIRE(s[0] == "7");
+        REQUIRE(s[9999] == "99997");
+    }
+
+    SECTION("several columns by one predicate") {
+        std::vector<double> w(v.size());
+        for (std::size_t i = 0; i != w.size(); ++i)
+            w[i] = 0.5 * double(i);
+        std::vector<int> v_out(v.size());
+        std::vector<double> w_out(v.size());
+
+        auto keep = [](auto row) { return std::get<0>(row) % 1000 == 0; };
+        auto last = drift::parallel_copy_if(pool, drift::zip(v, w), drift::zip(v_out, w_out), keep);
+        REQUIRE(last - drift::zip(v_out, w_out).begin() == 100);
+        REQUIRE(v_out[99] == 99000);
+        REQUIRE(w_out[99] == 49500.);
+
+        auto end = drift::parallel_remove_if(pool, drift::zip(v, w), keep);
+        REQUIRE(end - drift::zip(v, w).begin() == 99900);
+        REQUIRE(v[0] == 1);
+        REQUIRE(v[999] == 1001);
+        REQUIRE(w[999] == 500.5);
+    }
+
+    SECTION("empty ranges") {
+        std::vector<int> none;
+        REQUIRE(drift::parallel_copy_if(pool, none, none, odd) == none.end());
+        REQUIRE(drift::parallel_partition(pool, none, odd) == none.end());
+    }
+}
+
+TEST_CASE("set operations, merges and partial sorts", "[algo]") {
+    std::vector<int> a{1, 2, 2, 4, 6, 8, 9};
+    std::vector<int> b{2, 2, 2, 3, 6, 9, 10};
+    std::vector<int> out(a.size() + b.size());
+
+    auto written = [&](auto last) { return std::vector<int>(out.begin(), last); };
+
+    SECTION("set operations") {
+        REQUIRE(written(drift::set_intersection(a, b, out)) == std::vector<int>{2, 2, 6, 9});
+        REQUIRE(written(drift::set_union(a, b, out)) ==
+                std::vector<int>{1, 2, 2, 2, 3, 4, 6, 8, 9, 10});
+        REQUIRE(written(drift::set_difference(a, b, out)) == std::vector<int>{1, 4, 8});
+        REQUIRE(written(drift::set_symmetric_difference(a, b, out)) ==
+                std::vector<int>{1, 2, 3, 4, 8, 10});
+        REQUIRE(drift::includes(a, std::vector<int>{2, 4, 9}));
+        REQUIRE(!drift::includes(a, b));
+        REQUIRE(written(drift::set_intersection(a, b, out, std::less<>())) ==
+                std::vector<int>{2, 2, 6, 9});
+    }
+
+    SECTION("merges") {
+        REQUIRE(drift::merge(a, b, out) == out.end());
+        REQUIRE(std::is_sorted(out.begin(), out.end()));
+        drift::merge(a, b, out, std::less<>());
+        REQUIRE(std::is_sorted(out.begin(), out.end()));
+
+        std::vector<int> c{1, 3, 5, 2, 4, 6};
+        drift::inplace_merge(c, c.begin() + 3);
+        REQUIRE(c == std::vector<int>{1, 2, 3, 4, 5, 6});
+    }
+
+    SECTION("intersections of sorted lists take the fast paths") {
+        auto rng = std::mt19937(5);
+        auto sorted_list = [&](std::size_t n, unsigned range) {
+            std::vector<std::uint32_t> v(n);
+            for (auto &x : v)
+                x = rng() % range;
+            std::sort(v.begin(), v.end());
+            return v;
+        };
+
+        for (auto [n1, n2] : {std::pair<std::size_t, std::size_t>{1000, 1000}, {10, 100000},
+                              {100000, 3}, {0, 50}, {5000, 100000}}) {
+            auto x = sorted_list(n1, 20000);
+            auto y = sorted_list(n2, 20000);
+            std::vector<std::uint32_t> fast(std::min(n1, n2)), slow(std::min(n1, n2));
+            fast.erase(drift::set_intersection(x, y, fast), fast.end());
+            slow.erase(std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), slow.begin()),
+                       slow.end());
+            REQUIRE(fast == slow);
+
+            std::vector<std::uint32_t> merged(n1 + n2), expected(n1 + n2);
+            drift::merge(x, y, merged);
+            std::merge(x.begin(), x.end(), y.begin(), y.end(), expected.begin());
+            REQUIRE(merged == expected);
+        }
+    }
+
+    SECTION("partial sorts and rotations") {
+        std::vector<int> v{9, 4, 7, 1, 8, 2, 6};
+        drift::nth_element(v, v.begin() + 3);
+        REQUIRE(v[3] == 6);
+        drift::partial_sort(v, v.begin() + 3);
+        REQUIRE(std::vector<int>(v.begin(), v.begin() + 3) == std::vector<int>{1, 2, 4});
+        drift::partial_sort(v, v.begin() + 2, std::greater<>());
+        REQUIRE(std::vector<int>(v.begin(), v.begin() + 2) == std::vector<int>{9, 8});
+
+        std::vector<int> smallest(2);
+        drift::partial_sort_copy(v, smallest);
+        REQUIRE(smallest == std::vector<int>{1, 2});
+
+        std::vector<int> r{1, 2, 3, 4, 5};
+        REQUIRE(*drift::rotate(r, r.begin() + 2) == 1);
+        REQUIRE(r == std::vector<int>{3, 4, 5, 1, 2});
+        std::vector<int> r2(5);
+        drift::rotate_copy(r, r.begin() + 3, r2);
+        REQUIRE(r2 == std::vector<int>{1, 2, 3, 4, 5});
+    }
+
+    SECTION("searches and _n variants") {
+        std::vector<int> hay{1, 2, 3, 1, 2, 3, 4};
+        std::vector<int> needle{2, 3};
+        REQUIRE(drift::search(hay, needle) - hay.begin() == 1);
+        REQUIRE(drift::find_end(hay, needle) - hay.begin() == 4);
+        REQUIRE(*drift::find_first_of(hay, std::vector<int>{4, 3}) == 3);
+
+        std::vector<int> dst(4, 0);
+        drift::copy_n(hay, 3, dst);
+        REQUIRE(dst == std::vector<int>{1, 2, 3, 0});
+        drift::fill_n(dst, 2, 7);
+        REQUIRE(dst == std::vector<int>{7, 7, 3, 0});
+        int next = 0;
+        drift::generate_n(dst, 4, [&] { return next++; });
+        REQUIRE(dst == std::vector<int>{0, 1, 2, 3});
+        int sum = 0;
+        drift::for_each_n(dst, 3, [&](int x) { sum += x; });
+        REQUIRE(sum == 3);
+    }
+}
+
+TEST_CASE("parallel merge", "[algo]") {
+    drift::task_stealing_queue<> pool(4);
+
+    /* keys with many ties; the second member tells which input an element came from */
+    std::vector<std::pair<int, int>> a(60000), b(45000);
+    for (std::size_t i = 0; i != a.size(); ++i)
+        a[i] = {int(i / 7), 1};
+    for (std::size_t i = 0; i != b.size(); ++i)
+        b[i] = {int(i / 3), 2};
+    auto by_key = [](const auto &x, const auto &y) { return x.first < y.first; };
+
+    std::vector<std::pair<int, int>> out(a.size() + b.size()), expected(out.size());
+    std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin(), by_key);
+    REQUIRE(drift::parallel_merge(pool, a, b, out, by_key) == out.end());
+    REQUIRE(out == expected);
+
+    std::vector<int> x{1, 3, 5}, y{2, 4}, z(5);
+    drift::parallel_merge(pool, x, y, z);
+    REQUIRE(z == std::vector<int>{1, 2, 3, 4, 5});
+}
+
+TEST_CASE("parallel sorts", "[algo]") {
+    drift::task_stealing_queue<> pool(4);
+    auto rng = std::mt19937(11);
+
+    SECTION("agrees with std::sort, on every run count") {
+        for (std::size_t n : {0, 1, 1000, 1 << 15, 3 * (1 << 14) + 17, 200001}) {
+            std::vector<int> v(n);
+            for (auto &x : v)
+                x = int(rng() % 100000);
+            auto expected = v;
+            std::sort(expected.begin(), expected.end());
+            drift::parallel_sort(pool, v);
+            REQUIRE(v == expected);
+
+            std::shuffle(v.begin(), v.end(), rng);
+            drift::parallel_sort(pool, v, std::greater<>());
+            REQUIRE(std::equal(v.begin(), v.end(), expected.rbegin()));
+        }
+    }
+
+    SECTION("stable") {
+        /* few keys, the second member records the original position */
+        std::vector<std::pair<int, int>> v(150000);
+        for (std::size_t i = 0; i != v.size(); ++i)
+            v[i] = {int(rng() % 50), int(i)};
+        auto expected = v;
+        auto by_key = [](const auto &x, const auto &y) { return x.first < y.first; };
+        std::stable_sort(expected.begin(), expected.end(), by_key);
+        drift::parallel_stable_sort(pool, v, by_key);
+        REQUIRE(v == expected);
+    }
+
+    SECTION("zip") {
+        std::vector<int> keys(100000);
+        std::vector<std::string> names(keys.size());
+        for (std::size_t i = 0; i != keys.size(); ++i) {
+            keys[i] = int(rng() % 1000);
+            names[i] = std::to_string(keys[i]);
+        }
+        drift::parallel_stable_sort(pool, drift::zip(keys, names));
+        REQUIRE(std::is_sorted(keys.begin(), keys.end()));
+        auto consistent = true;
+        for (auto [k, name] : drift::zip(keys, names))
+            consistent = consistent && name == std::to_string(k);
+        REQUIRE(consistent);
+    }
+}
+
+TEST_CASE("summaries", "[algo]") {
+    auto rng = std::mt19937(5);
+    std::vector<int> a(100003);
+    std::vector<double> b(a.size());
+    for (std::size_t i = 0; i != a.size(); ++i) {
+        a[i] = int(rng() % 2001) - 1000;
+        b[i] = 1e6 + std::uniform_real_distribution<double>(0., 1.)(rng);
+    }
+
+    auto two_pass_variance = [](const auto &v) {
+        auto mean = std::accumulate(v.begin(), v.end(), 0.) / double(v.size());
+        auto m2 = 0.;
+        for (auto x : v)
+            m2 += (double(x) - mean) * (double(x) - mean);
+        return m2 / double(v.size());
+    };
+
+    SECTION("one column") {
+        auto s = drift::summarize(a);
+        REQUIRE(s.count == a.size());
+        REQUIRE(s.sum == std::accumulate(a.begin(), a.end(), std::int64_t(0)));
+        REQUIRE(s.min == *std::min_element(a.begin(), a.end()));
+        REQUIRE(s.max == *std::max_element(a.begin(), a.end()));
+        REQUIRE(s.mean() == Approx(double(s.sum) / double(a.size())));
+        REQUIRE(s.variance() == Approx(two_pass_variance(a)));
+    }
+
+    SECTION("zipped columns, serial and on a pool") {
+        drift::task_stealing_queue<> pool(4);
+        auto [sa, sb] = drift::summarize(drift::zip(a, b));
+        auto [pa, pb] = drift::summarize(pool, drift::zip(a, b));
+
+        REQUIRE(sa.sum == pa.sum);
+        REQUIRE(sa.min == pa.min);
+        REQUIRE(sb.max == *std::max_element(b.begin(), b.end()));
+        REQUIRE(pb.max == sb.max);
+        REQUIRE(pa.variance() == Approx(two_pass_variance(a)));
+        /* a large offset and a small spread, where sum-of-squares formulas fall apart */
+        REQUIRE(sb.variance() == Approx(two_pass_variance(b)).epsilon(1e-9));
+        REQUIRE(pb.variance() == Approx(two_pass_variance(b)).epsilon(1e-9));
+        REQUIRE(pb.sample_variance() > pb.variance());
+    }
+
+    SECTION("chosen statistics only") {
+        std::vector<std::uint8_t> small{200, 100, 250, 3};
+        auto s = drift::summarize<drift::stats::min | drift::stats::max>(small);
+        REQUIRE(s.count == 4);
+        REQUIRE(s.min == 3);
+        REQUIRE(s.max == 250);
+        REQUIRE(s.sum == 0);
+        REQUIRE(drift::summarize<drift::stats::sum>(small).sum == 553);
+    }
+
+    SECTION("empty ranges and nans") {
+        std::vector<float> none;
+        REQUIRE(drift::summarize(none).count == 0);
+
+        std::vector<float> f(3000, 1.f);
+        f[2500] = std::numeric_limits<float>::quiet_NaN();
+        auto s = drift::summarize(f);
+        REQUIRE(s.min != s.min);
+        REQUIRE(s.max != s.max);
+        f[2500] = -4.f;
+        REQUIRE(drift::summarize(f).min == -4.f);
+    }
+}
+
+namespace {
+/* counts what goes through it to the default resource */
+class counting_resource : public std::pmr::memory_resource {
+public:
+    std::atomic<std::size_t> allocations{0}, live{0};
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        ++live;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        --live;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+} // namespace
+
+TEST_CASE("memory resources", "[algo]") {
+    auto rng = std::mt19937(13);
+    std::vector<int> v(100000);
+    for (auto &x : v)
+        x = int(rng() % 100000);
+    auto sorted = v;
+    std::sort(sorted.begin(), sorted.end());
+
+    SECTION("algorithms take their scratch space from the pool's resource") {
+        drift::task_stealing_queue<> pool(4);
+        counting_resource counted;
+        auto scratch_pool = drift::with_resource(pool, &counted);
+
+        auto w = v;
+        drift::parallel_sort(scratch_pool, w);
+        REQUIRE(w == sorted);
+        REQUIRE(counted.allocations > 0);
+
+        auto before = counted.allocations.load();
+        w = v;
+        drift::radix_sort(scratch_pool, w);
+        REQUIRE(w == sorted);
+        REQUIRE(counted.allocations > before);
+
+        before = counted.allocations.load();
+        w = v;
+        auto kept = drift::parallel_remove_if(scratch_pool, w, [](int x) { return x % 2; });
+        REQUIRE(std::all_of(w.begin(), kept, [](int x) { return x % 2 == 0; }));
+        REQUIRE(counted.allocations > before);
+        REQUIRE(counted.live == 0);
+    }
+
+    SECTION("a monotonic arena per request") {
+        drift::task_stealing_queue<> pool(4);
+        for (int request = 0; request != 3; ++request) {
+            std::pmr::monotonic_buffer_resource arena;
+            drift::synchronized_resource shared(&arena);
+            auto request_pool = drift::with_resource(pool, &shared);
+            auto w = v;
+            drift::parallel_stable_sort(request_pool, w);
+            REQUIRE(w == sorted);
+        }
+    }
+
+    SECTION("task queues allocate from the pool's resource") {
+        counting_resource counted;
+        {
+            drift::task_stealing_queue<> pool(4, &counted);
+            std::atomic<int> runs{0};
+            std::vector<std::future<void>> futures;
+            for (int i = 0; i != 1000; ++i)
+                futures.push_back(pool.async([&runs] { ++runs; }));
+            for (auto &f : futures)
+                f.get();
+            REQUIRE(runs == 1000);
+            REQUIRE(counted.allocations >= 1000);
+
+            drift::multi_queue<int> ints(2, &counted);
+            drift::single_queue<int> more(2, &counted);
+            REQUIRE(ints.async([] { return 1; }).get() + more.async([] { return 2; }).get() == 3);
+        }
+        REQUIRE(counted.live == 0);
+    }
+
+    SECTION("thread caching resources recycle blocks freed on other threads") {
+        counting_resource upstream;
+        {
+            drift::thread_caching_resource cached(&upstream);
+            std::vector<std::uint64_t *> blocks(20000);
+            for (int round = 0; round != 5; ++round) {
+                for (std::size_t i = 0; i != blocks.size(); ++i) {
+                    blocks[i] = static_cast<std::uint64_t *>(cached.allocate(8 + i % 200));
+                    *blocks[i] = i;
+                }
+                auto intact = true;
+                std::thread([&] {
+                    for (std::size_t i = 0; i != blocks.size(); ++i) {
+                        intact = intact && *blocks[i] == i;
+                        cached.deallocate(blocks[i], 8 + i % 200);
+                    }
+                }).join();
+                REQUIRE(intact);
+            }
+            /* the later rounds reuse what the first one carved out */
+            auto after_one_round = upstream.allocations.load();
+            for (std::size_t i = 0; i != blocks.size(); ++i)
+                blocks[i] = static_cast<std::uint64_t *>(cached.allocate(8 + i % 200));
+            for (std::size_t i = 0; i != blocks.size(); ++i)
+                cached.deallocate(blocks[i], 8 + i % 200);
+            REQUIRE(upstream.allocations < after_one_round + after_one_round / 4);
+
+            auto big = cached.allocate(4096);
+            cached.deallocate(big, 4096);
+        }
+        REQUIRE(upstream.live == 0);
+    }
+
+    SECTION("threads that exit leave their caches to the next ones") {
+        counting_resource upstream;
+        {
+            drift::thread_caching_resource cached(&upstream);
+            auto first = cached.allocate(32);
+            auto p = first;
+            auto recycled = true;
+            for (int t = 0; t != 50; ++t) {
+                std::thread([&] {
+                    /* a block of the main thread's, which waits in a batch until this one exits */
+                    cached.deallocate(p, 32);
+                    cached.deallocate(cached.allocate(48), 48);
+                }).join();
+                p = cached.allocate(32);
+                recycled = recycled && p == first;
+            }
+            cached.deallocate(p, 32);
+            REQUIRE(recycled);
+            /* one chunk for the main thread, one shared by all the others in turn */
+            REQUIRE(upstream.allocations == 2);
+        }
+        REQUIRE(upstream.live == 0);
+    }
+}
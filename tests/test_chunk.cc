@@ -0,0 +1,136 @@
+#include <forward_list>
+#include <list>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../include/drift.h"
+#include "../../catch2/catch.hpp"
+
+TEST_CASE("chunk splits a range into slices", "[chunk]") {
+    std::vector<int> v(10);
+    std::iota(v.begin(), v.end(), 0);
+
+    SECTION("last chunk is shorter") {
+        std::vector<std::vector<int>> chunks;
+        for (auto c : drift::chunk(v, 4))
+            chunks.emplace_back(c.begin(), c.end());
+
+        REQUIRE(chunks == std::vector<std::vector<int>>{{0, 1, 2, 3}, {4, 5, 6, 7}, {8, 9}});
+    }
+
+    SECTION("size") {
+        REQUIRE(drift::chunk(v, 4).size() == 3);
+        REQUIRE(drift::chunk(v, 5).size() == 2);
+        REQUIRE(drift::chunk(v, 20).size() == 1);
+        REQUIRE(drift::chunk(std::vector<int>{}, 3).size() == 0);
+    }
+
+    SECTION("chunk size must be positive") {
+        REQUIRE_THROWS_AS(drift::chunk(v, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(drift::chunk(v, -2), std::invalid_argument);
+    }
+
+    SECTION("random access indexing") {
+        auto c = drift::chunk(v, 3);
+        REQUIRE(std::is_same_v<decltype(c.begin())::iterator_category,
+                               std::random_access_iterator_tag>);
+        REQUIRE(*c.begin()[2].begin() == 6);
+        REQUIRE(c.begin()[3].size() == 1);
+        REQUIRE((c.begin() + 4) == c.end());
+        REQUIRE((*(c.end() - 1)).size() == 1);
+    }
+
+    SECTION("walking back from the end") {
+        auto c = drift::chunk(v, 4);
+        auto it = c.end();
+        --it;
+        REQUIRE(*(*it).begin() == 8);
+        --it;
+        REQUIRE(*(*it).begin() == 4);
+        REQUIRE((c.end() - 3) == c.begin());
+    }
+
+    SECTION("mutation through slices") {
+        for (auto c : drift::chunk(v, 3))
+            for (auto &x : c)
+                x = c.size();
+
+        REQUIRE(v == std::vector<int>{3, 3, 3, 3, 3, 3, 3, 3, 3, 1});
+    }
+
+    SECTION("lists") {
+        const std::list<int> l(v.begin(), v.end());
+        auto c = drift::chunk(l, 4);
+        REQUIRE(std::is_same_v<decltype(c.begin())::iterator_category,
+                               std::bidirectional_iterator_tag>);
+        auto it = c.end();
+        --it;
+        REQUIRE((*it).size() == 2);
+
+        const std::forward_list<int> fl(v.begin(), v.end());
+        int n = 0;
+        for (auto s : drift::chunk(fl, 3))
+            n += s.size();
+        REQUIRE(n == 10);
+    }
+
+    SECTION("chunks of a zip range") {
+        std::vector<int> w(10, 1);
+        int sum = 0;
+        for (auto c : drift::chunk(drift::zip(v, w), 4))
+            for (auto [a, b] : c)
+                sum += a * b;
+        REQUIRE(sum == 45);
+    }
+}
+
+TEST_CASE("tile2d splits a row-major range into blocks", "[chunk]") {
+    const int rows = 5, cols = 7;
+    std::vector<int> m(rows * cols);
+    std::iota(m.begin(), m.end(), 0);
+
+    SECTION("tiles cover every element exactly once") {
+        std::vector<int> seen(m.size(), 0);
+        for (auto t : drift::tile2d(m, rows, cols, 3))
+            for (auto row : t)
+                for (auto x : row)
+                    ++seen[x];
+
+        REQUIRE(seen == std::vector<int>(m.size(), 1));
+    }
+
+    SECTION("tile geometry") {
+        auto tiles = drift::tile2d(m, rows, cols, 3);
+        REQUIRE(tiles.size() == 6);
+
+        auto last = tiles.begin()[5];
+        REQUIRE(last.row() == 3);
+        REQUIRE(last.col() == 6);
+        REQUIRE(last.rows() == 2);
+        REQUIRE(last.cols() == 1);
+        REQUIRE(*(*last.begin()).begin() == 3 * cols + 6);
+    }
+
+    SECTION("rows within a tile are strided") {
+        auto t = *drift::tile2d(m, rows, cols, 2).begin();
+        std::vector<int> firsts;
+        for (auto row : t)
+            firsts.push_back(*row.begin());
+        REQUIRE(firsts == std::vector<int>{0, 7});
+    }
+
+    SECTION("extents are checked") {
+        REQUIRE_THROWS_AS(drift::tile2d(m, rows, cols, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(drift::tile2d(m, -1, cols, 2), std::invalid_argument);
+        REQUIRE_THROWS_AS(drift::tile2d(m, rows, -1, 2), std::invalid_argument);
+    }
+
+    SECTION("row ranges of edge tiles stay inside the range") {
+        /* the bottom-right tile ends exactly at the end of the range */
+        auto last = drift::tile2d(m, rows, cols, 3).begin()[5];
+        REQUIRE(last.end() - last.begin() == 2);
+        REQUIRE(*(*(last.end() - 1)).begin() == 4 * cols + 6);
+    }
+}
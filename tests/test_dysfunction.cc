@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/* counts allocations, for the dysfunctions that promise not to make any */
+#define DRIFT_COUNT_ALLOCATIONS
+#include "../bench.h"
+#include "../include/dysfunction.h"
+#include "../include/tasks.h"
+#include "../../catch2/catch.hpp"
+
+TEST_CASE("dysfunction picks the overload for each signature", "[dysfunction]") {
+    drift::dysfunction<std::string, int, const std::string &, double> f(
+        [](int i) { return "int " + std::to_string(i); },
+        [](const std::string &s) { return "string " + s; },
+        [](double) { return std::string("double"); });
+
+    REQUIRE(f(3) == "int 3");
+    REQUIRE(f(std::string("x")) == "string x");
+    REQUIRE(f(2.5) == "double");
+
+    SECTION("one generic lambda covers every signature") {
+        drift::dysfunction<int, int, double> g([](auto x) { return int(x * 2); });
+        REQUIRE(g(4) == 8);
+        REQUIRE(g(1.5) == 3);
+    }
+
+    SECTION("void results and reference arguments") {
+        drift::dysfunction<void, int &, std::string &> inc(
+            [](int &i) { ++i; }, [](std::string &s) { s += "!"; });
+        int i = 1;
+        std::string s = "hi";
+        inc(i);
+        inc(s);
+        REQUIRE(i == 2);
+        REQUIRE(s == "hi!");
+    }
+}
+
+TEST_CASE("dysfunction copies and moves its overload set", "[dysfunction]") {
+    auto count = std::make_shared<int>(0);
+    auto make = [&] {
+        return drift::dysfunction<int, int, const char *>(
+            [count, calls = 0](int) mutable { return ++calls; }, [](const char *) { return -1; });
+    };
+
+    SECTION("small sets") {
+        auto f = make();
+        REQUIRE(f(0) == 1);
+        auto g = f;
+        REQUIRE(g(0) == 2);
+        REQUIRE(f(0) == 2);
+
+        auto h = std::move(f);
+        REQUIRE(h(0) == 3);
+        REQUIRE(h("c") == -1);
+        REQUIRE_THROWS_AS(f(0), std::bad_function_call);
+
+        f = h;
+        REQUIRE(f(0) == 4);
+        REQUIRE(count.use_count() == 4);
+    }
+
+    SECTION("sets too large to be stored in place") {
+        char big[128] = {};
+        drift::dysfunction<int, int> f([big, count](int i) mutable { return big[0] += char(i); });
+        REQUIRE(f(2) == 2);
+        auto g = f;
+        REQUIRE(g(3) == 5);
+        REQUIRE(f(1) == 3);
+        g = std::move(f);
+        REQUIRE(g(1) == 4);
+        REQUIRE(count.use_count() == 2);
+    }
+
+    REQUIRE(count.use_count() == 1);
+}
+
+namespace {
+/* counts its copies and moves, and can be told to have a throwing move constructor */
+template <bool nothrow_move>
+struct counted {
+    int *copies, *moves;
+
+    counted(int *copies, int *moves) : copies(copies), moves(moves) {}
+    counted(const counted &other) : copies(other.copies), moves(other.moves) { ++*copies; }
+    counted(counted &&other) noexcept(nothrow_move) : copies(other.copies), moves(other.moves) {
+        ++*moves;
+    }
+
+    const void *operator()(int) const { return this; }
+};
+} // namespace
+
+TEST_CASE("dysfunction moves never throw", "[dysfunction]") {
+    using f_type = drift::dysfunction<const void *, int>;
+    static_assert(std::is_nothrow_move_constructible_v<f_type>);
+    static_assert(std::is_nothrow_move_assignable_v<f_type>);
+    static_assert(std::is_nothrow_swappable_v<f_type>);
+
+    int copies = 0, moves = 0;
+
+    SECTION("vectors grow by moving") {
+        std::vector<f_type> v;
+        for (int i = 0; i != 100; ++i)
+            v.emplace_back(counted<true>(&copies, &moves));
+        REQUIRE(copies == 0);
+        for (auto &f : v)
+            REQUIRE(f(0) != nullptr);
+    }
+
+    SECTION("sets with throwing moves stay where they are") {
+        f_type f(counted<false>(&copies, &moves));
+        auto where = f(0);
+        moves = 0;
+        auto g = std::move(f);
+        f_type h;
+        swap(g, h);
+        REQUIRE(moves == 0);
+        REQUIRE(h(0) == where);
+        REQUIRE(!f);
+        REQUIRE(!g);
+        REQUIRE_THROWS_AS(g(0), std::bad_function_call);
+    }
+
+    SECTION("across threads") {
+        drift::task_stealing_queue<> pool(2);
+        drift::dysfunction<int, int> twice([](int i) { return 2 * i; });
+        int result = 0;
+        pool.async([&result, f = std::move(twice)] { result = f(21); }).get();
+        REQUIRE(result == 42);
+        REQUIRE(!twice);
+    }
+}
+
+namespace {
+/* a visitor-style loop of the kind dysfunction_ref is meant for */
+int visit_all(const std::vector<int> &v, drift::dysfunction_ref<int, int, const char *> f) {
+    int total = 0;
+    for (auto x : v)
+        total += f(x);
+    return total + f("end");
+}
+} // namespace
+
+TEST_CASE("dysfunction_ref calls what it references", "[dysfunction]") {
+    using ref_type = drift::dysfunction_ref<int, int, const char *>;
+    static_assert(std::is_trivially_copyable_v<ref_type>);
+
+    int calls = 0;
+    auto set = drift::overloaded{[&](int i) { return ++calls, i; },
+                                 [](const char *) { return 100; }};
+    REQUIRE(visit_all({1, 2, 3}, set) == 106);
+    REQUIRE(calls == 3);
+
+    SECTION("a temporary lives as long as the call") {
+        REQUIRE(visit_all({4}, drift::overloaded{[](int i) { return -i; },
+                                                 [](const char *) { return 0; }}) == -4);
+    }
+
+    SECTION("copies reference the same set, and so can owning dysfunctions") {
+        drift::dysfunction<int, int, const char *> owner(set);
+        ref_type r = owner;
+        auto r2 = r;
+        REQUIRE(r2(5) == 5);
+        REQUIRE(calls == 4);
+        REQUIRE(r2("x") == 100);
+    }
+
+    SECTION("mutable and const sets") {
+        struct counter {
+            int n = 0;
+            int operator()(int i) { return n += i; }
+            int operator()(const char *) const { return n; }
+        } c;
+        ref_type r = c;
+        r(2);
+        r(3);
+        REQUIRE(c.n == 5);
+        const auto &cc = c;
+        drift::dysfunction_ref<int, const char *> read_only = cc;
+        REQUIRE(read_only("n") == 5);
+    }
+}
+
+TEST_CASE("inplace_dysfunction never allocates", "[dysfunction]") {
+    using f_type = drift::inplace_dysfunction<64, int, int, const char *>;
+    static_assert(sizeof(f_type) <= 64 + alignof(std::max_align_t));
+    static_assert(std::is_nothrow_move_constructible_v<f_type>);
+
+    char pad[48] = {1};
+    auto before = allocations.load();
+    f_type f([pad](int i) { return pad[0] + i; }, [](const char *) { return 0; });
+    auto g = f;
+    f_type h = std::move(f);
+    g = h;
+    swap(g, h);
+    REQUIRE(g(1) == 2);
+    REQUIRE(h("x") == 0);
+    REQUIRE(!f);
+    REQUIRE(allocations == before);
+}
+
+namespace {
+struct ping {
+    int n;
+};
+struct pong {
+    std::string s;
+};
+} // namespace
+
+TEST_CASE("dysfunction dispatches ranges of variants", "[dysfunction]") {
+    std::vector<int> pings;
+    std::vector<std::string> pongs;
+    double doubles = 0;
+    drift::dysfunction<int, const ping &, pong &, double> f(
+        [&](const ping &p) { return pings.push_back(p.n), 0; },
+        [&](pong &p) { return pongs.push_back(p.s), 1; }, [&](double d) { return doubles += d, 2; });
+
+    /* the alternatives come in a different order than the signatures */
+    std::vector<std::variant<double, pong, ping>> messages;
+    for (int i = 0; i != 1000; ++i) {
+        if (i % 3 == 0)
+            messages.emplace_back(ping{i});
+        else if (i % 7 == 0)
+            messages.emplace_back(pong{std::to_string(i)});
+        else
+            messages.emplace_back(0.5);
+    }
+
+    f.dispatch(messages);
+    REQUIRE(pings.size() == 334);
+    REQUIRE(std::is_sorted(pings.begin(), pings.end()));
+    REQUIRE(pongs.size() == 95);
+    REQUIRE(pongs.front() == "7");
+    REQUIRE(pongs.back() == "994");
+    REQUIRE(doubles == 0.5 * double(1000 - 334 - 95));
+
+    SECTION("const ranges, and empty ones") {
+        std::vector<std::variant<ping, double>> few{ping{1}, 2.0, ping{3}};
+        const auto &read_only = few;
+        pings.clear();
+        f.dispatch(read_only);
+        REQUIRE(pings == std::vector<int>{1, 3});
+        f.dispatch(std::vector<std::variant<ping>>());
+        REQUIRE(pings.size() == 2);
+    }
+
+    SECTION("empty dysfunctions") {
+        decltype(f) empty;
+        REQUIRE_THROWS_AS(empty.dispatch(messages), std::bad_function_call);
+    }
+}
+
+TEST_CASE("static_dysfunction calls without type erasure", "[dysfunction]") {
+    constexpr auto table = drift::make_dispatch_table<int, int, double, const char *>(
+        [](int i) { return i + 1; }, [](double d) { return int(d * 10); },
+        [](const char *s) { return int(*s); });
+    static_assert(table(1) == 2);
+    static_assert(table(0.5) == 5);
+    static_assert(table.visit(std::variant<double, int>(3)) == 4);
+
+    std::vector<std::variant<int, double, const char *>> v{1, 2.5, "a", 7};
+    int total = 0;
+    for (auto &m : v) {
+        total += table.visit(m);
+        REQUIRE(std::visit(table, m) == table.visit(m));
+    }
+    REQUIRE(total == 2 + 25 + 'a' + 8);
+
+    SECTION("constant expressions with state, and mutable sets") {
+        constexpr auto offset =
+            drift::make_dispatch_table<int, int>([k = 3](int i) { return i + k; });
+        static_assert(offset(1) == 4);
+        static_assert(offset.visit(std::variant<int>(2)) == 5);
+
+        auto sum = drift::make_dispatch_table<int, int>([n = 0](int i) mutable { return n += i; });
+        sum(1);
+        REQUIRE(sum(2) == 3);
+        REQUIRE(sum.visit(std::variant<int>(4)) == 7);
+    }
+
+    SECTION("stateful sets and dispatch") {
+        std::vector<int> pings;
+        auto counter = drift::make_dispatch_table<void, const ping &>(
+            [&](const ping &p) { pings.push_back(p.n); });
+        std::vector<std::variant<ping>> messages{ping{1}, ping{2}};
+        counter.dispatch(messages);
+        REQUIRE(pings == std::vector<int>{1, 2});
+
+        /* it is callable, so owning dysfunctions can be made from it */
+        drift::dysfunction<void, const ping &> erased(counter);
+        erased(ping{3});
+        REQUIRE(pings.back() == 3);
+    }
+}
@@ -2,6 +2,8 @@
 // #include <functional>
 // #include <numeric>
 // #include <string>
+#include <array>
+#include <optional>
 #include <vector>
 
 
@@ -21,3 +23,102 @@ TEST_CASE("simple counter", "[gen]") {
         REQUIRE(v == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
     }
 }
+
+TEST_CASE("values are produced once per increment", "[gen]") {
+    int calls = 0;
+    auto gen = drift::generator([&calls]() { return ++calls; });
+
+    auto it = gen.begin();
+    REQUIRE(*it == 1);
+    REQUIRE(*it == 1);
+    REQUIRE(calls == 1);
+
+    ++it;
+    REQUIRE(*it == 2);
+    REQUIRE(*it++ == 2);
+    REQUIRE(*it == 3);
+    REQUIRE(calls == 3);
+    REQUIRE(gen.begin() == it);
+}
+
+TEST_CASE("generators can end", "[gen]") {
+    auto count_to_five = [n = 0]() mutable -> std::optional<int> {
+        if (n == 5)
+            return std::nullopt;
+        return n++;
+    };
+
+    SECTION("optional-returning producers") {
+        std::vector<int> v;
+        for (auto i : drift::generator(count_to_five))
+            v.push_back(i);
+        REQUIRE(v == std::vector<int>{0, 1, 2, 3, 4});
+    }
+
+    SECTION("an empty range") {
+        auto gen = drift::generator([]() -> std::optional<int> { return std::nullopt; });
+        REQUIRE(gen.begin() == gen.end());
+    }
+
+    SECTION("until a sentinel value") {
+        std::vector<int> v;
+        for (auto i : drift::generator(drift::until([n = 0]() mutable { return n++; }, 3)))
+            v.push_back(i);
+        REQUIRE(v == std::vector<int>{0, 1, 2});
+    }
+
+    SECTION("indexed and zip") {
+        std::vector<int> w{10, 11, 12, 13, 14};
+        auto gen = drift::generator(count_to_five);
+        for (auto [i, n] : drift::indexed(gen))
+            REQUIRE(i == n);
+
+        auto gen2 = drift::generator(count_to_five);
+        for (auto [n, x] : drift::zip(gen2, w))
+            REQUIRE(x == n + 10);
+    }
+}
+
+TEST_CASE("batched generation", "[gen]") {
+    SECTION("element by element") {
+        auto gen = drift::generator([n = 0]() mutable -> std::optional<int> {
+            if (n == 6)
+                return std::nullopt;
+            return n++;
+        });
+        std::array<int, 4> buf{};
+        REQUIRE(gen.next_n(buf) == 4);
+        REQUIRE(buf == std::array<int, 4>{0, 1, 2, 3});
+        REQUIRE(gen.next_n(buf) == 2);
+        REQUIRE(buf[0] == 4);
+        REQUIRE(buf[1] == 5);
+    }
+
+    SECTION("the cached value comes first") {
+        auto gen = drift::generator([n = 0]() mutable { return n++; });
+        REQUIRE(*gen.begin() == 0);
+        std::vector<int> buf(3);
+        gen.next_n(buf);
+        REQUIRE(buf == std::vector<int>{0, 1, 2});
+        REQUIRE(*gen.begin() == 3);
+    }
+
+    SECTION("producers with a bulk overload") {
+        struct iota {
+            int n = 0;
+            int bulk_calls = 0;
+            int operator()() { return n++; }
+            std::size_t operator()(int *first, std::size_t count) {
+                ++bulk_calls;
+                for (std::size_t i = 0; i != count; ++i)
+                    first[i] = n++;
+                return count;
+            }
+        };
+        auto gen = drift::generator(iota{});
+        std::vector<int> buf(5);
+        REQUIRE(gen.next_n(buf) == 5);
+        REQUIRE(buf == std::vector<int>{0, 1, 2, 3, 4});
+        REQUIRE(*gen.begin() == 5);
+    }
+}
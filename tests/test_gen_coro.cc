@@ -0,0 +1,130 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/drift.h"
+#include "../../catch2/catch.hpp"
+
+#if defined(__cpp_impl_coroutine)
+
+namespace {
+drift::generator<int> iota(int n) {
+    while (true)
+        co_yield n++;
+}
+
+drift::generator<int> range(int first, int last) {
+    for (int i = first; i != last; ++i)
+        co_yield i;
+}
+
+drift::generator<std::string> words(std::string text) {
+    std::string word;
+    for (auto c : text) {
+        if (c == ' ') {
+            if (!word.empty())
+                co_yield word;
+            word.clear();
+        } else {
+            word += c;
+        }
+    }
+    if (!word.empty())
+        co_yield word;
+}
+
+struct tree {
+    int value;
+    std::unique_ptr<tree> left, right;
+};
+
+drift::generator<int> in_order(const tree *t) {
+    if (!t)
+        co_return;
+    for (auto v : in_order(t->left.get()))
+        co_yield v;
+    co_yield t->value;
+    for (auto v : in_order(t->right.get()))
+        co_yield v;
+}
+
+drift::generator<int> throwing() {
+    co_yield 1;
+    throw std::runtime_error("oops");
+}
+} // namespace
+
+TEST_CASE("coroutine generators", "[gen]") {
+    SECTION("endless") {
+        std::vector<int> v;
+        for (auto i : iota(3)) {
+            if (i > 6)
+                break;
+            v.push_back(i);
+        }
+        REQUIRE(v == std::vector<int>{3, 4, 5, 6});
+    }
+
+    SECTION("finite, and values are read in place") {
+        auto g = range(0, 3);
+        auto it = g.begin();
+        REQUIRE(*it == 0);
+        REQUIRE(*it == 0);
+        ++it;
+        REQUIRE(*it == 1);
+        ++it;
+        ++it;
+        REQUIRE(it == g.end());
+    }
+
+    SECTION("empty") {
+        auto g = range(0, 0);
+        REQUIRE(g.begin() == g.end());
+    }
+
+    SECTION("stateful producers") {
+        std::vector<std::string> v;
+        for (auto &w : words("  the quick  brown fox "))
+            v.push_back(std::move(w));
+        REQUIRE(v == std::vector<std::string>{"the", "quick", "brown", "fox"});
+    }
+
+    SECTION("recursive walks") {
+        auto t = tree{4, std::make_unique<tree>(tree{2, nullptr, nullptr}),
+                      std::make_unique<tree>(tree{6, std::make_unique<tree>(tree{5, nullptr, nullptr}),
+                                                  nullptr})};
+        std::vector<int> v;
+        for (auto x : in_order(&t))
+            v.push_back(x);
+        REQUIRE(v == std::vector<int>{2, 4, 5, 6});
+    }
+
+    SECTION("indexed and zip") {
+        auto g = range(10, 15);
+        for (auto [i, x] : drift::indexed(g))
+            REQUIRE(x == i + 10);
+
+        std::vector<int> w{0, 1, 2, 3, 4};
+        auto h = range(0, 5);
+        for (auto [x, y] : drift::zip(h, w))
+            REQUIRE(x == y);
+    }
+
+    SECTION("exceptions propagate to the consumer") {
+        auto g = throwing();
+        auto it = g.begin();
+        REQUIRE(*it == 1);
+        REQUIRE_THROWS_AS(++it, std::runtime_error);
+    }
+
+    SECTION("many short-lived generators") {
+        long sum = 0;
+        for (int i = 0; i != 10000; ++i)
+            for (auto x : range(0, 2))
+                sum += x;
+        REQUIRE(sum == 10000);
+    }
+}
+
+#endif
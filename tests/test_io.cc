@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../include/algorithm.h"
+#include "../include/drift.h"
+#include "../include/io.h"
+#include "../include/tasks.h"
+#include "../../catch2/catch.hpp"
+
+namespace {
+/* a file in the temp directory, removed when it goes out of scope */
+struct temp_file {
+    std::string path;
+
+    explicit temp_file(const std::string &name)
+      : path((std::filesystem::temp_directory_path() / name).string()) {}
+    ~temp_file() { std::remove(path.c_str()); }
+
+    template <typename T>
+    void write(const std::vector<T> &v) const {
+        std::ofstream f(path, std::ios::binary);
+        f.write(reinterpret_cast<const char *>(v.data()), std::streamsize(v.size() * sizeof(T)));
+    }
+};
+} // namespace
+
+TEST_CASE("mapped arrays", "[io]") {
+    std::vector<float> x(1000), y(1000);
+    std::iota(x.begin(), x.end(), 0.f);
+    std::iota(y.begin(), y.end(), 1000.f);
+
+    temp_file fx("drift_test_x.bin"), fy("drift_test_y.bin");
+    fx.write(x);
+    fy.write(y);
+
+    SECTION("read only, zipped") {
+        auto mx = drift::mapped_array<const float>(fx.path, drift::map_mode::read_only,
+                                                   drift::map_access::sequential);
+        auto my = drift::mapped_array<const float>(fy.path);
+        REQUIRE(mx.size() == 1000);
+
+        int i = 0;
+        for (auto [a, b] : drift::zip(mx, my)) {
+            REQUIRE(a == x[i]);
+            REQUIRE(b == y[i]);
+            ++i;
+        }
+        REQUIRE(i == 1000);
+    }
+
+    SECTION("indexed") {
+        auto mx = drift::mapped_array<float>(fx.path);
+        for (auto [i, a] : drift::indexed(mx))
+            REQUIRE(a == float(i));
+    }
+
+    SECTION("read write") {
+        {
+            auto mx = drift::mapped_array<float>(fx.path, drift::map_mode::read_write);
+            mx[3] = -1.f;
+            mx.sync();
+        }
+        auto mx = drift::mapped_array<const float>(fx.path);
+        REQUIRE(mx[3] == -1.f);
+    }
+
+    SECTION("copy on write") {
+        {
+            auto mx = drift::mapped_array<float>(fx.path, drift::map_mode::copy_on_write);
+            mx[3] = -1.f;
+            REQUIRE(mx[3] == -1.f);
+        }
+        {
+            /* arrays of non-const T are copy on write by default */
+            auto mx = drift::mapped_array<float>(fx.path);
+            mx[4] = -2.f;
+            REQUIRE(mx[4] == -2.f);
+        }
+        auto mx = drift::mapped_array<const float>(fx.path);
+        REQUIRE(mx[3] == 3.f);
+        REQUIRE(mx[4] == 4.f);
+    }
+
+    SECTION("creating a file") {
+        temp_file fz("drift_test_z.bin");
+        {
+            auto mz = drift::mapped_array<double>(fz.path, 500);
+            REQUIRE(mz.size() == 500);
+            std::iota(mz.begin(), mz.end(), 0.);
+        }
+        auto mz = drift::mapped_array<const double>(fz.path);
+        REQUIRE(mz.size() == 500);
+        REQUIRE(mz[499] == 499.);
+    }
+
+    SECTION("empty files and errors") {
+        temp_file fe("drift_test_empty.bin");
+        fe.write(std::vector<int>{});
+        auto me = drift::mapped_array<int>(fe.path);
+        REQUIRE(me.empty());
+        REQUIRE(me.begin() == me.end());
+
+        REQUIRE_THROWS_AS(drift::mapped_array<int>(fe.path + ".missing"), std::system_error);
+        REQUIRE_THROWS_AS(drift::mapped_array<const int>(fe.path, drift::map_mode::read_write),
+                          std::invalid_argument);
+    }
+
+    SECTION("moves") {
+        auto mx = drift::mapped_array<float>(fx.path);
+        auto mx2 = std::move(mx);
+        REQUIRE(mx.empty());
+        REQUIRE(mx2.size() == 1000);
+        REQUIRE(mx2[10] == 10.f);
+    }
+}
+
+TEST_CASE("records", "[io]") {
+    temp_file f("drift_test_records.txt");
+    auto write = [&](const std::string &text) {
+        std::ofstream(f.path, std::ios::binary) << text;
+    };
+    auto read_all = [&](std::size_t block_size, char delimiter = '\n') {
+        std::vector<std::string> v;
+        for (auto r : drift::records(f.path, delimiter, block_size))
+            v.emplace_back(r);
+        return v;
+    };
+
+    const auto lines = std::vector<std::string>{
+        "first", "", "a somewhat longer line that spans several small blocks", "x", "last"};
+    std::string text;
+    for (auto &l : lines)
+        text += l + "\n";
+
+    SECTION("any block size gives the same records") {
+        write(text);
+        for (std::size_t block : {1, 2, 3, 7, 16, 1024})
+            REQUIRE(read_all(block) == lines);
+    }
+
+    SECTION("no trailing delimiter") {
+        write("a,b,,c");
+        REQUIRE(read_all(2, ',') == std::vector<std::string>{"a", "b", "", "c"});
+    }
+
+    SECTION("empty file") {
+        write("");
+        REQUIRE(read_all(4).empty());
+    }
+
+    SECTION("indexed line numbers and algorithms") {
+        write(text);
+        auto r = drift::records(f.path, '\n', 8);
+        std::vector<std::ptrdiff_t> empty_lines;
+        for (auto [n, line] : drift::indexed(r))
+            if (line.empty())
+                empty_lines.push_back(n);
+        REQUIRE(empty_lines == std::vector<std::ptrdiff_t>{1});
+
+        auto r2 = drift::records(f.path, '\n', 8);
+        REQUIRE(drift::count_if(r2, [](auto l) { return l.size() > 3; }) == 3);
+    }
+
+    SECTION("on a task pool") {
+        write(text);
+        drift::task_stealing_queue<> pool(2);
+        std::vector<std::string> v;
+        for (auto r : drift::records(pool, f.path, '\n', 5))
+            v.emplace_back(r);
+        REQUIRE(v == lines);
+    }
+
+    SECTION("missing files") {
+        REQUIRE_THROWS_AS(drift::records(f.path + ".missing"), std::system_error);
+    }
+}
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../include/drift.h"
+#include "../include/relational.h"
+#include "../include/tasks.h"
+#include "../../catch2/catch.hpp"
+
+TEST_CASE("group_by", "[relational]") {
+    namespace agg = drift::aggregate;
+
+    SECTION("groups in order of first appearance") {
+        auto keys = std::vector<std::string>{"b", "a", "b", "c", "a", "b"};
+        auto vals = std::vector<int>{1, 2, 3, 4, 5, 6};
+        auto table = drift::zip(keys, vals, vals, vals, vals, vals);
+        auto [k, n, sum, lo, hi, mean] =
+            drift::group_by(table, agg::count, agg::sum, agg::min, agg::max, agg::mean);
+        REQUIRE(k == std::vector<std::string>{"b", "a", "c"});
+        REQUIRE(n == std::vector<std::size_t>{3, 2, 1});
+        REQUIRE(sum == std::vector<std::int64_t>{10, 7, 4});
+        REQUIRE(lo == std::vector<int>{1, 2, 4});
+        REQUIRE(hi == std::vector<int>{6, 5, 4});
+        REQUIRE(mean == std::vector<double>{10. / 3, 3.5, 4.});
+    }
+
+    SECTION("empty tables and folds") {
+        auto keys = std::vector<int>();
+        auto words = std::vector<std::string>();
+        auto [k, joined] = drift::group_by(drift::zip(keys, words), agg::fold(std::plus<>()));
+        REQUIRE(k.empty());
+        REQUIRE(joined.empty());
+
+        keys = {1, 2, 1};
+        words = {"x", "y", "z"};
+        auto [k2, joined2] = drift::group_by(drift::zip(keys, words), agg::fold(std::plus<>()));
+        REQUIRE(k2 == std::vector<int>{1, 2});
+        REQUIRE(joined2 == std::vector<std::string>{"xz", "y"});
+    }
+
+    SECTION("on a pool, the same as serially") {
+        auto pool = drift::task_stealing_queue<>(4);
+        auto rng = std::mt19937_64(3);
+        for (std::uint64_t distinct : {1ull, 100ull, 100000ull, 1ull << 40}) {
+            auto n = std::size_t(1) << 19;
+            auto keys = std::vector<std::uint64_t>(n);
+            auto vals = std::vector<std::int32_t>(n);
+            auto tags = std::vector<std::string>(n);
+            for (std::size_t i = 0; i != n; ++i) {
+                keys[i] = rng() % distinct;
+                vals[i] = std::int32_t(rng() % 1000) - 500;
+                tags[i] = std::string(1, char('a' + i % 26));
+            }
+            /* concatenating the first letter of a group's values checks the merge order */
+            auto first_letters = agg::fold([](std::string s, const std::string &t) {
+                return s.size() < 8 ? s + t.substr(0, 8 - s.size()) : s;
+            });
+            auto table = drift::zip(keys, vals, vals, vals, tags);
+            auto serial = drift::group_by(table, agg::count, agg::sum, agg::max, first_letters);
+            auto parallel =
+                drift::group_by(pool, table, agg::count, agg::sum, agg::max, first_letters);
+            REQUIRE(serial == parallel);
+
+            auto counts = std::map<std::uint64_t, std::size_t>();
+            for (auto k : keys)
+                ++counts[k];
+            auto expected = std::vector<std::size_t>();
+            for (auto k : std::get<0>(serial))
+                expected.push_back(counts[k]);
+            REQUIRE(std::get<0>(serial).size() == counts.size());
+            REQUIRE(std::get<1>(serial) == expected);
+        }
+    }
+}
+
+TEST_CASE("hash_join", "[relational]") {
+    auto first_column = [](auto &&row) { return std::get<0>(row); };
+
+    SECTION("matches every pair of rows with equal keys") {
+        auto ids = std::vector<int>{3, 1, 4, 1, 5};
+        auto names = std::vector<std::string>{"c", "a", "d", "a'", "e"};
+        auto refs = std::vector<int>{1, 9, 4, 1, 3};
+        auto [build, probe] =
+            drift::hash_join(drift::zip(ids, names), drift::zip(refs), first_column);
+        auto pairs = std::vector<std::pair<std::size_t, std::size_t>>();
+        for (std::size_t i = 0; i != build.size(); ++i)
+            pairs.emplace_back(build[i], probe[i]);
+        std::sort(pairs.begin(), pairs.end());
+        REQUIRE(pairs == std::vector<std::pair<std::size_t, std::size_t>>{
+                             {0, 4}, {1, 0}, {1, 3}, {2, 2}, {3, 0}, {3, 3}});
+    }
+
+    SECTION("empty sides") {
+        auto none = std::vector<int>();
+        auto some = std::vector<int>{1, 2};
+        auto key = [](int x) { return x; };
+        REQUIRE(std::get<0>(drift::hash_join(none, some, key)).empty());
+        REQUIRE(std::get<0>(drift::hash_join(some, none, key)).empty());
+    }
+
+    SECTION("on a pool, the same as serially, and as a multimap") {
+        auto pool = drift::task_stealing_queue<>(4);
+        auto rng = std::mt19937_64(5);
+        for (std::size_t n_build : {std::size_t(1000), std::size_t(1) << 18}) {
+            auto n_probe = 2 * n_build;
+            auto build_keys = std::vector<std::uint64_t>(n_build);
+            auto probe_keys = std::vector<std::uint64_t>(n_probe);
+            for (auto &k : build_keys)
+                k = rng() % n_build;
+            for (auto &k : probe_keys)
+                k = rng() % (2 * n_build);
+            auto serial = drift::hash_join(drift::zip(build_keys), drift::zip(probe_keys),
+                                           first_column);
+            auto parallel = drift::hash_join(pool, drift::zip(build_keys),
+                                             drift::zip(probe_keys), first_column);
+            REQUIRE(serial == parallel);
+
+            std::pmr::monotonic_buffer_resource arena;
+            drift::synchronized_resource shared(&arena);
+            auto arena_pool = drift::with_resource(pool, &shared);
+            REQUIRE(drift::hash_join(arena_pool, drift::zip(build_keys), drift::zip(probe_keys),
+                                     first_column) == serial);
+
+            auto rows_of = std::multimap<std::uint64_t, std::size_t>();
+            for (std::size_t i = 0; i != n_build; ++i)
+                rows_of.emplace(build_keys[i], i);
+            auto expected = std::vector<std::pair<std::size_t, std::size_t>>();
+            for (std::size_t j = 0; j != n_probe; ++j) {
+                auto range = rows_of.equal_range(probe_keys[j]);
+                for (auto it = range.first; it != range.second; ++it)
+                    expected.emplace_back(it->second, j);
+            }
+            auto pairs = std::vector<std::pair<std::size_t, std::size_t>>();
+            for (std::size_t i = 0; i != std::get<0>(serial).size(); ++i)
+                pairs.emplace_back(std::get<0>(serial)[i], std::get<1>(serial)[i]);
+            std::sort(expected.begin(), expected.end());
+            std::sort(pairs.begin(), pairs.end());
+            REQUIRE(pairs == expected);
+        }
+    }
+}
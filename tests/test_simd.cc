@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "../include/algorithm.h"
+#include "../include/simd.h"
+#include "../../catch2/catch.hpp"
+
+namespace {
+/* runs f once for every instruction set this cpu supports */
+template <typename F>
+void for_each_isa(F f) {
+    using drift::simd::isa;
+    for (auto i : {isa::scalar, isa::sse2, isa::avx2, isa::avx512}) {
+        if (drift::simd::supported_isa() < i)
+            break;
+        drift::simd::limit_isa(i);
+        f();
+    }
+    drift::simd::limit_isa(isa::avx512);
+}
+
+/* small values, so that counts and finds hit something */
+template <typename T>
+std::vector<T> random_values(std::size_t n, std::mt19937 &rng) {
+    auto v = std::vector<T>(n);
+    for (auto &x : v)
+        x = T(int(rng() % 19) - 9);
+    return v;
+}
+
+/* checks the drift:: versions against the std:: ones on all lengths up to a few vectors, so
+ * that every tail gets exercised
+ */
+template <typename T>
+void check_against_std() {
+    auto rng = std::mt19937(7);
+    for (std::size_t n = 0; n < 300; n += 1 + n / 16) {
+        auto v = random_values<T>(n, rng);
+        auto w = random_values<T>(n, rng);
+
+        REQUIRE(drift::count(v, T(3)) == std::count(v.begin(), v.end(), T(3)));
+        REQUIRE(drift::count(v, T(100)) == 0);
+        REQUIRE(drift::find(v, T(-2)) == std::find(v.begin(), v.end(), T(-2)));
+        REQUIRE(drift::find(v, T(100)) == v.end());
+
+        REQUIRE(drift::min_element(v) == std::min_element(v.begin(), v.end()));
+        REQUIRE(drift::max_element(v) == std::max_element(v.begin(), v.end()));
+        REQUIRE(drift::minmax_element(v) == std::minmax_element(v.begin(), v.end()));
+
+        if constexpr (std::is_integral_v<T>) {
+            REQUIRE(drift::accumulate(v, T(5)) == std::accumulate(v.begin(), v.end(), T(5)));
+            REQUIRE(drift::inner_product(v, w, T(1)) ==
+                    std::inner_product(v.begin(), v.end(), w.begin(), T(1)));
+        }
+    }
+}
+} // namespace
+
+TEST_CASE("simd kernels agree with std", "[simd]") {
+    for_each_isa([] {
+        check_against_std<std::int8_t>();
+        check_against_std<std::uint8_t>();
+        check_against_std<std::int16_t>();
+        check_against_std<std::uint16_t>();
+        check_against_std<int>();
+        check_against_std<unsigned>();
+        check_against_std<std::int64_t>();
+        check_against_std<std::uint64_t>();
+        check_against_std<float>();
+        check_against_std<double>();
+    });
+}
+
+TEST_CASE("simd edge cases", "[simd]") {
+    SECTION("narrow counters don't wrap") {
+        auto v = std::vector<std::uint8_t>(100000, 1);
+        for_each_isa([&] { REQUIRE(drift::count(v, std::uint8_t(1)) == 100000); });
+    }
+
+    SECTION("sums wrap like std::accumulate") {
+        auto v = std::vector<std::uint16_t>(5000, 60000);
+        auto w = std::vector<std::uint64_t>(1000, std::numeric_limits<std::uint64_t>::max() / 999);
+        for_each_isa([&] {
+            REQUIRE(drift::accumulate(v, std::uint16_t(7)) ==
+                    std::accumulate(v.begin(), v.end(), std::uint16_t(7)));
+            REQUIRE(drift::inner_product(v, v, std::uint16_t(0)) ==
+                    std::inner_product(v.begin(), v.end(), v.begin(), std::uint16_t(0)));
+            REQUIRE(drift::accumulate(w, std::uint64_t(0)) ==
+                    std::accumulate(w.begin(), w.end(), std::uint64_t(0)));
+        });
+    }
+
+    SECTION("extremes at the ends, and ties") {
+        auto v = std::vector<int>(100, 4);
+        v.front() = -1;
+        v.back() = 9;
+        for_each_isa([&] {
+            REQUIRE(drift::min_element(v) == v.begin());
+            REQUIRE(drift::max_element(v) == v.end() - 1);
+        });
+
+        auto flat = std::vector<double>(77, 2.);
+        for_each_isa([&] {
+            auto [lo, hi] = drift::minmax_element(flat);
+            REQUIRE(lo == flat.begin());
+            REQUIRE(hi == flat.end() - 1);
+            REQUIRE(drift::max_element(flat) == flat.begin());
+        });
+    }
+
+    SECTION("signed zeros and nans") {
+        auto v = std::vector<float>(50, 1.f);
+        v[10] = 0.f;
+        v[20] = -0.f;
+        for_each_isa([&] {
+            REQUIRE(drift::min_element(v) - v.begin() == 10);
+            REQUIRE(drift::count(v, -0.f) == 2);
+        });
+
+        v[30] = std::numeric_limits<float>::quiet_NaN();
+        v[2] = -std::numeric_limits<float>::quiet_NaN();
+        for_each_isa([&] {
+            REQUIRE(drift::min_element(v) == std::min_element(v.begin(), v.end()));
+            REQUIRE(drift::minmax_element(v) == std::minmax_element(v.begin(), v.end()));
+            REQUIRE(drift::find(v, v[30]) == v.end());
+        });
+    }
+
+    SECTION("arrays and mixed types") {
+        int a[] = {3, 1, 4, 1, 5, 9, 2, 6};
+        REQUIRE(drift::count(a, 1) == 2);
+        REQUIRE(*drift::max_element(a) == 9);
+
+        /* the init type decides the arithmetic, so this one must not go through simd.h */
+        auto v = std::vector<int>(3, std::numeric_limits<int>::max());
+        REQUIRE(drift::accumulate(v, std::int64_t(0)) ==
+                3 * std::int64_t(std::numeric_limits<int>::max()));
+        REQUIRE(drift::count(v, 2.5) == 0);
+    }
+}
@@ -476,4 +476,68 @@ TEST_CASE("vector of vectors", "[zip]") {
 //         REQUIRE(v == std::vector<int>{5, 1, 2, 3, 4, 0});
 //         REQUIRE(w == std::vector<int>{1, 7, 8, 9, 0, 6});
 //     }
-// }
\ No newline at end of file
+// }
+TEST_CASE("splittable ranges", "[zip]") {
+    auto v1 = std::vector{1, 2, 3, 4, 5, 6, 7};
+    auto v2 = std::vector{7., 6., 5., 4., 3., 2., 1.};
+
+    SECTION("zip, indexed, reverse_view and tail are splittable") {
+        REQUIRE(drift::is_splittable_v<decltype(drift::zip(v1, v2))>);
+        REQUIRE(drift::is_splittable_v<decltype(drift::indexed(v1))>);
+        REQUIRE(drift::is_splittable_v<decltype(drift::reverse_view(v1))>);
+        REQUIRE(drift::is_splittable_v<decltype(drift::tail(v1))>);
+        REQUIRE(!drift::is_splittable_v<decltype(drift::zip(std::list<int>{}))>);
+    }
+
+    SECTION("halves of a zip range") {
+        auto [lo, hi] = drift::zip(v1, v2).split();
+        REQUIRE(lo.size() == 3);
+        REQUIRE(hi.size() == 4);
+        auto [a, b] = *hi.begin();
+        REQUIRE(a == 4);
+        REQUIRE(b == 4.);
+    }
+
+    SECTION("pieces of an indexed range keep global indices") {
+        auto [lo, hi] = drift::indexed(drift::zip(v1, v2)).split(5);
+        auto [hilo, hihi] = hi.split();
+        REQUIRE(hilo.size() == 1);
+        for (auto [i, ab] : hihi) {
+            auto [a, b] = ab;
+            REQUIRE(i == 6);
+            REQUIRE(a == v1[i]);
+            REQUIRE(b == v2[i]);
+        }
+    }
+
+    SECTION("reverse_view and tail") {
+        auto [lo, hi] = drift::reverse_view(v1).split(2);
+        REQUIRE(*lo.begin() == 7);
+        REQUIRE(*hi.begin() == 5);
+
+        auto [tlo, thi] = drift::tail(v1, 3).split();
+        REQUIRE(*tlo.begin() == 4);
+        REQUIRE(*thi.begin() == 6);
+    }
+}
+
+TEST_CASE("indexed iterators carry their index", "[zip]") {
+    const std::list<int> l = {4, 5, 6};
+
+    SECTION("forward walk over a list") {
+        int n = 0;
+        for (auto [i, x] : drift::indexed(l)) {
+            REQUIRE(i == n);
+            REQUIRE(x == 4 + n);
+            ++n;
+        }
+    }
+
+    SECTION("walking back from the end") {
+        auto it = drift::indexed(l).end();
+        --it;
+        auto [i, x] = *it;
+        REQUIRE(i == 2);
+        REQUIRE(x == 6);
+    }
+}